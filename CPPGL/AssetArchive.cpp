@@ -0,0 +1,379 @@
+#include "AssetArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <utility>
+
+const char AssetArchive::MAGIC[4] = { 'C', 'P', 'A', 'K' };
+
+namespace {
+	// a match has to be at least this long to be worth its token and offset
+	const size_t MIN_MATCH = 4;
+	const size_t MAX_OFFSET = 65535;
+	const int HASH_BITS = 16;
+
+	uint32_t read32(const unsigned char *bytes) {
+		uint32_t value;
+		memcpy(&value, bytes, sizeof(value));
+		return value;
+	}
+
+	// lengths past what fits in a token nibble carry on in bytes of 255, ending on one that isn't
+	void writeLength(std::vector<unsigned char> &out, size_t length) {
+		for (; length >= 255; length -= 255) {
+			out.push_back(255);
+		}
+		out.push_back((unsigned char)length);
+	}
+
+	void writeSequence(std::vector<unsigned char> &out, const unsigned char *literals, size_t literalCount,
+		size_t offset, size_t matchLength)
+	{
+		size_t matchCode = matchLength > 0 ? matchLength - MIN_MATCH : 0;
+		out.push_back((unsigned char)((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15)));
+		if (literalCount >= 15) {
+			writeLength(out, literalCount - 15);
+		}
+		out.insert(out.end(), literals, literals + literalCount);
+		if (matchLength == 0) {
+			return;
+		}
+		out.push_back((unsigned char)(offset & 0xff));
+		out.push_back((unsigned char)(offset >> 8));
+		if (matchCode >= 15) {
+			writeLength(out, matchCode - 15);
+		}
+	}
+
+	// sequences of a token (literal count, match length), the literals, then a
+	// 16 bit offset back to copy the match from. the last sequence is only literals
+	std::vector<unsigned char> compress(const unsigned char *bytes, size_t size) {
+		std::vector<unsigned char> out;
+		out.reserve(size / 2 + 16);
+		// where each 4 byte sequence was last seen, plus one so 0 is empty
+		std::vector<uint32_t> seen((size_t)1 << HASH_BITS, 0);
+		size_t anchor = 0;
+		size_t i = 0;
+		while (i + MIN_MATCH <= size) {
+			uint32_t sequence = read32(bytes + i);
+			uint32_t slot = (sequence * 2654435761u) >> (32 - HASH_BITS);
+			size_t candidate = seen[slot];
+			seen[slot] = (uint32_t)(i + 1);
+			if (candidate == 0 || i - (candidate - 1) > MAX_OFFSET || read32(bytes + candidate - 1) != sequence) {
+				i++;
+				continue;
+			}
+			size_t match = candidate - 1;
+			size_t length = MIN_MATCH;
+			while (i + length < size && bytes[match + length] == bytes[i + length]) {
+				length++;
+			}
+			writeSequence(out, bytes + anchor, i - anchor, i - match, length);
+			i += length;
+			anchor = i;
+		}
+		writeSequence(out, bytes + anchor, size - anchor, 0, 0);
+		return out;
+	}
+
+	bool readLength(const unsigned char *&in, const unsigned char *end, size_t &length) {
+		for (;;) {
+			if (in == end) {
+				return false;
+			}
+			unsigned char next = *in++;
+			length += next;
+			if (next != 255) {
+				return true;
+			}
+		}
+	}
+
+	// false if it runs off either end or doesn't come out exactly rawSize long
+	bool decompress(const unsigned char *in, size_t size, unsigned char *out, size_t rawSize) {
+		const unsigned char *end = in + size;
+		size_t written = 0;
+		while (in < end) {
+			unsigned char token = *in++;
+			size_t literals = token >> 4;
+			if (literals == 15 && !readLength(in, end, literals)) {
+				return false;
+			}
+			if (literals > (size_t)(end - in) || literals > rawSize - written) {
+				return false;
+			}
+			memcpy(out + written, in, literals);
+			in += literals;
+			written += literals;
+			if (in == end) {
+				break;
+			}
+			if (end - in < 2) {
+				return false;
+			}
+			size_t offset = in[0] | (in[1] << 8);
+			in += 2;
+			size_t length = token & 15;
+			if (length == 15 && !readLength(in, end, length)) {
+				return false;
+			}
+			length += MIN_MATCH;
+			if (offset == 0 || offset > written || length > rawSize - written) {
+				return false;
+			}
+			const unsigned char *from = out + written - offset;
+			if (offset >= length) {
+				memcpy(out + written, from, length);
+			} else {
+				// byte by byte, the match overlaps what it's writing (a run)
+				for (size_t j = 0; j < length; j++) {
+					out[written + j] = from[j];
+				}
+			}
+			written += length;
+		}
+		return written == rawSize;
+	}
+
+	bool readFile(const std::string &path, std::vector<unsigned char> &bytes) {
+		std::ifstream in(path, std::ios::binary);
+		if (!in) {
+			return false;
+		}
+		bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		return !in.bad();
+	}
+}
+
+AssetArchive::AssetArchive() : header(NULL), entries(NULL), names(NULL) {
+}
+
+AssetArchive::AssetArchive(const char *path) : AssetArchive() {
+	file = MappedFile(path);
+	if (file.IsOpen() && !validate(path)) {
+		file.Close();
+	}
+}
+
+AssetArchive::AssetArchive(AssetArchive &&other) noexcept : AssetArchive() {
+	take(other);
+}
+
+AssetArchive &AssetArchive::operator=(AssetArchive &&other) noexcept {
+	if (this != &other) {
+		take(other);
+	}
+	return *this;
+}
+
+void AssetArchive::take(AssetArchive &other) {
+	file = std::move(other.file);
+	header = other.header;
+	entries = other.entries;
+	names = other.names;
+	other.header = NULL;
+	other.entries = NULL;
+	other.names = NULL;
+}
+
+void AssetArchive::Close() {
+	file.Close();
+	header = NULL;
+	entries = NULL;
+	names = NULL;
+}
+
+bool AssetArchive::validate(const char *path) {
+	const unsigned char *bytes = file.Data();
+	size_t size = file.Size();
+	const Header *candidate = (const Header*)bytes;
+	if (size < sizeof(Header) || memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0
+		|| candidate->version != VERSION)
+	{
+		std::cout << "couldn't open " << path << ": not an asset archive, or packed by another version" << std::endl;
+		return false;
+	}
+	const Entry *table = (const Entry*)(bytes + sizeof(Header));
+	if ((size - sizeof(Header)) / sizeof(Entry) < candidate->count
+		|| candidate->namesOffset > size || candidate->namesSize > size - candidate->namesOffset)
+	{
+		std::cout << "couldn't open " << path << ": it's been cut short" << std::endl;
+		return false;
+	}
+	for (uint32_t i = 0; i < candidate->count; i++) {
+		const Entry &entry = table[i];
+		// every blob has its zero byte after it. that byte isn't checked, it'd page
+		// in a piece of every asset just to open the archive
+		bool inside = entry.offset < size && entry.size < size - entry.offset
+			&& (uint64_t)entry.nameOffset + entry.nameLength <= candidate->namesSize;
+		bool sorted = i == 0 || table[i - 1].hash <= entry.hash;
+		// lz can't do better than 255 to 1, so anything bigger is a bad table, not a big asset
+		bool sized = entry.compression == NONE ? entry.rawSize == entry.size
+			: entry.compression == LZ && entry.rawSize / 255 <= entry.size;
+		if (!inside || !sorted || !sized) {
+			std::cout << "couldn't open " << path << ": entry " << i << " is corrupt" << std::endl;
+			return false;
+		}
+	}
+	header = candidate;
+	entries = table;
+	names = (const char*)bytes + candidate->namesOffset;
+	return true;
+}
+
+uint64_t AssetArchive::Hash(const char *name, size_t length) {
+	// 64 bit FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= (unsigned char)name[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+AssetArchive::View AssetArchive::At(size_t index) const {
+	const Entry &entry = entries[index];
+	return { file.Data() + entry.offset, (size_t)entry.size, (Compression)entry.compression, (size_t)entry.rawSize };
+}
+
+std::string AssetArchive::Name(size_t index) const {
+	return std::string(names + entries[index].nameOffset, entries[index].nameLength);
+}
+
+AssetArchive::View AssetArchive::Find(const std::string &name) const {
+	if (!IsOpen()) {
+		return { NULL, 0, NONE, 0 };
+	}
+	uint64_t hash = Hash(name.data(), name.size());
+	const Entry *end = entries + header->count;
+	const Entry *entry = std::lower_bound(entries, end, hash,
+		[](const Entry &e, uint64_t value) { return e.hash < value; });
+	for (; entry != end && entry->hash == hash; ++entry) {
+		if (entry->nameLength == name.size() && memcmp(names + entry->nameOffset, name.data(), name.size()) == 0) {
+			return At((size_t)(entry - entries));
+		}
+	}
+	return { NULL, 0, NONE, 0 };
+}
+
+bool AssetArchive::Read(const std::string &name, std::vector<unsigned char> &bytes) const {
+	View view = Find(name);
+	if (!view.Found()) {
+		std::cout << "couldn't find " << name << " in the asset archive" << std::endl;
+		return false;
+	}
+	if (view.compression == NONE) {
+		bytes.assign(view.data, view.data + view.size);
+		return true;
+	}
+	bytes.resize(view.rawSize);
+	if (!decompress(view.data, view.size, bytes.data(), view.rawSize)) {
+		std::cout << "couldn't decompress " << name << " from the asset archive" << std::endl;
+		bytes.clear();
+		return false;
+	}
+	return true;
+}
+
+bool AssetArchive::Pack(const char *output, const std::vector<Input> &inputs, const PackOptions &options,
+	PackReport *report)
+{
+	uint32_t alignment = options.alignment < 16 ? 16 : options.alignment;
+	if ((alignment & (alignment - 1)) != 0) {
+		std::cout << "can't pack " << output << ", the alignment has to be a power of two" << std::endl;
+		return false;
+	}
+
+	struct Packed {
+		const Input *input;
+		uint64_t hash;
+		std::vector<unsigned char> bytes;
+		uint64_t rawSize;
+		uint32_t compression;
+	};
+	std::vector<Packed> packed(inputs.size());
+	PackReport totals = {};
+	for (size_t i = 0; i < inputs.size(); i++) {
+		Packed &item = packed[i];
+		item.input = &inputs[i];
+		item.hash = Hash(inputs[i].name.data(), inputs[i].name.size());
+		if (!readFile(inputs[i].path, item.bytes)) {
+			std::cout << "can't pack " << output << ", couldn't read " << inputs[i].path << std::endl;
+			return false;
+		}
+		item.rawSize = item.bytes.size();
+		item.compression = NONE;
+		totals.rawBytes += item.rawSize;
+		if (options.compress && !item.bytes.empty()) {
+			std::vector<unsigned char> smaller = compress(item.bytes.data(), item.bytes.size());
+			if (smaller.size() < item.bytes.size()) {
+				item.bytes.swap(smaller);
+				item.compression = LZ;
+				totals.compressed++;
+			}
+		}
+	}
+	std::sort(packed.begin(), packed.end(), [](const Packed &a, const Packed &b) {
+		return a.hash != b.hash ? a.hash < b.hash : a.input->name < b.input->name;
+	});
+	for (size_t i = 1; i < packed.size(); i++) {
+		if (packed[i].input->name == packed[i - 1].input->name) {
+			std::cout << "can't pack " << output << ", " << packed[i].input->name << " is in it twice" << std::endl;
+			return false;
+		}
+	}
+
+	Header header = {};
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.count = (uint32_t)packed.size();
+	header.alignment = alignment;
+	header.namesOffset = sizeof(Header) + sizeof(Entry) * packed.size();
+	std::vector<Entry> table(packed.size());
+	std::string nameBlock;
+	for (size_t i = 0; i < packed.size(); i++) {
+		table[i].hash = packed[i].hash;
+		table[i].nameOffset = (uint32_t)nameBlock.size();
+		table[i].nameLength = (uint32_t)packed[i].input->name.size();
+		table[i].compression = packed[i].compression;
+		table[i].rawSize = packed[i].rawSize;
+		table[i].size = packed[i].bytes.size();
+		nameBlock += packed[i].input->name;
+	}
+	header.namesSize = nameBlock.size();
+	uint64_t offset = header.namesOffset + header.namesSize;
+	for (Entry &entry : table) {
+		offset = (offset + alignment - 1) & ~(uint64_t)(alignment - 1);
+		entry.offset = offset;
+		// and the zero byte
+		offset += entry.size + 1;
+	}
+
+	std::ofstream out(output, std::ios::binary | std::ios::trunc);
+	if (!out) {
+		std::cout << "couldn't write " << output << std::endl;
+		return false;
+	}
+	out.write((const char*)&header, sizeof(header));
+	out.write((const char*)table.data(), (std::streamsize)(sizeof(Entry) * table.size()));
+	out.write(nameBlock.data(), (std::streamsize)nameBlock.size());
+	std::vector<char> padding(alignment, 0);
+	uint64_t position = header.namesOffset + header.namesSize;
+	for (size_t i = 0; i < table.size(); i++) {
+		out.write(padding.data(), (std::streamsize)(table[i].offset - position));
+		out.write((const char*)packed[i].bytes.data(), (std::streamsize)packed[i].bytes.size());
+		out.put(0);
+		position = table[i].offset + table[i].size + 1;
+	}
+	if (!out) {
+		std::cout << "couldn't write " << output << std::endl;
+		return false;
+	}
+	if (report != NULL) {
+		*report = totals;
+		report->bytes = position;
+	}
+	return true;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+// a .pak from cppgl_pack: every asset packed into one file that's mapped once,
+// so finding one is a binary search over the table of contents and reading it
+// is a pointer into the mapping, with no open, allocation or copy per asset.
+// the layout is a header, the table sorted by name hash, the names, then each
+// blob on an alignment boundary followed by a zero byte, so text assets can be
+// used as C strings straight from the mapping. blobs can be lz compressed,
+// those have to go through Read instead. everything is little endian
+class AssetArchive {
+public:
+	// bump VERSION whenever the layout changes
+	static const char MAGIC[4];
+	static const uint32_t VERSION = 1;
+
+	enum Compression : uint32_t {
+		NONE,
+		// byte oriented lz77 in the style of lz4: fast to decode, a few times smaller on text and meshes
+		LZ
+	};
+
+	struct Header {
+		char magic[4];
+		uint32_t version;
+		uint32_t count;
+		// every blob starts on a multiple of this
+		uint32_t alignment;
+		// the names block, from the start of the file
+		uint64_t namesOffset;
+		uint64_t namesSize;
+	};
+
+	// the table of these follows the header, sorted by hash then name
+	struct Entry {
+		uint64_t hash;
+		// from the start of the file, and what's stored there
+		uint64_t offset;
+		uint64_t size;
+		// what it decompresses to, size when it isn't compressed
+		uint64_t rawSize;
+		// into the names block, not zero terminated
+		uint32_t nameOffset;
+		uint32_t nameLength;
+		uint32_t compression;
+		uint32_t reserved;
+	};
+
+	// an asset as it sits in the mapping, valid as long as the archive is open.
+	// data is NULL if there's no such asset
+	struct View {
+		const unsigned char *data;
+		size_t size;
+		Compression compression;
+		size_t rawSize;
+
+		bool Found() const { return data != NULL; }
+	};
+
+	// a file to pack and the name to look it up by
+	struct Input {
+		std::string name;
+		std::string path;
+	};
+
+	struct PackOptions {
+		// compress each blob, keeping it stored when that doesn't save anything
+		bool compress = false;
+		// a power of two, at least 16 so cooked textures keep their level alignment
+		uint32_t alignment = 16;
+	};
+
+	struct PackReport {
+		uint64_t bytes;
+		// before compression, blobs only
+		uint64_t rawBytes;
+		uint32_t compressed;
+	};
+
+	AssetArchive();
+	// IsOpen() is false if it can't be mapped or isn't a valid archive, the reason has been printed
+	explicit AssetArchive(const char *path);
+	AssetArchive(AssetArchive &&other) noexcept;
+	AssetArchive &operator=(AssetArchive &&other) noexcept;
+	AssetArchive(const AssetArchive &) = delete;
+	AssetArchive &operator=(const AssetArchive &) = delete;
+
+	bool IsOpen() const { return header != NULL; }
+	size_t Count() const { return IsOpen() ? header->count : 0; }
+	// names use forward slashes, the way cppgl_pack stored them
+	View Find(const std::string &name) const;
+	// the whole asset, decompressed if it has to be. false if there's no such
+	// asset or it doesn't decompress, the reason has been printed
+	bool Read(const std::string &name, std::vector<unsigned char> &bytes) const;
+	// for listing what's in it, in table order
+	std::string Name(size_t index) const;
+	View At(size_t index) const;
+	void Close();
+
+	// writes inputs into a new archive at output. prints why if it can't
+	static bool Pack(const char *output, const std::vector<Input> &inputs, const PackOptions &options,
+		PackReport *report = NULL);
+	static uint64_t Hash(const char *name, size_t length);
+
+private:
+	MappedFile file;
+	const Header *header;
+	const Entry *entries;
+	const char *names;
+
+	// checks every table entry lands inside the file
+	bool validate(const char *path);
+	void take(AssetArchive &other);
+};
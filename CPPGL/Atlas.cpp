@@ -0,0 +1,126 @@
+#include "Atlas.h"
+#include "GLState.h"
+#include "stb/stb_image.h"
+#include <algorithm>
+#include <iostream>
+
+Atlas::Atlas(GLsizei size, GLsizei border, int pageLimit)
+	: pageSize(size), padding(border), maxPages(pageLimit)
+{
+}
+
+int Atlas::Pack(const std::vector<std::string> &files) {
+	struct Image {
+		const std::string *file;
+		unsigned char *pixels;
+		int width, height;
+	};
+	std::vector<Image> images;
+	int failed = 0;
+	for (const std::string &file : files) {
+		Image image = { &file, NULL, 0, 0 };
+		int channels;
+		image.pixels = stbi_load(file.c_str(), &image.width, &image.height, &channels, 4);
+		if (image.pixels == NULL) {
+			std::cout << "couldn't load atlas image " << file << ": " << stbi_failure_reason() << std::endl;
+			failed++;
+			continue;
+		}
+		images.push_back(image);
+	}
+
+	// longest side first, the big ones are the hardest to fit later
+	std::sort(images.begin(), images.end(), [](const Image &a, const Image &b) {
+		int sideA = std::max(a.width, a.height);
+		int sideB = std::max(b.width, b.height);
+		return sideA != sideB ? sideA > sideB : a.width * a.height > b.width * b.height;
+	});
+	for (Image &image : images) {
+		if (!Insert(*image.file, image.pixels, image.width, image.height)) {
+			failed++;
+		}
+		stbi_image_free(image.pixels);
+	}
+	return failed;
+}
+
+bool Atlas::Insert(const std::string &name, const unsigned char *pixels, GLsizei width, GLsizei height) {
+	GLsizei paddedWidth = width + padding * 2;
+	GLsizei paddedHeight = height + padding * 2;
+	RectPacker::Rect placed;
+	int page = -1;
+	for (size_t i = 0; i < packers.size() && page < 0; i++) {
+		if (packers[i].Insert(paddedWidth, paddedHeight, placed)) {
+			page = (int)i;
+		}
+	}
+	if (page < 0) {
+		if ((int)pages.size() >= maxPages || paddedWidth > pageSize || paddedHeight > pageSize) {
+			std::cout << "atlas has no room for " << name << " (" << width << "x" << height << ")" << std::endl;
+			return false;
+		}
+		pages.emplace_back(pageSize, pageSize, GL_NEAREST, GL_CLAMP_TO_EDGE, 1);
+		packers.emplace_back(pageSize, pageSize);
+		page = (int)pages.size() - 1;
+		packers[page].Insert(paddedWidth, paddedHeight, placed);
+	}
+
+	// the image with its edge rows and columns repeated out into the padding
+	std::vector<unsigned char> padded((size_t)paddedWidth * paddedHeight * 4);
+	for (GLsizei y = 0; y < paddedHeight; y++) {
+		GLsizei sourceY = std::min(std::max(y - padding, 0), height - 1);
+		for (GLsizei x = 0; x < paddedWidth; x++) {
+			GLsizei sourceX = std::min(std::max(x - padding, 0), width - 1);
+			const unsigned char *from = pixels + ((size_t)sourceY * width + sourceX) * 4;
+			std::copy(from, from + 4, padded.begin() + ((size_t)y * paddedWidth + x) * 4);
+		}
+	}
+	GLState::BindTexture(GL_TEXTURE_2D, pages[page].ID);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, placed.x, placed.y, paddedWidth, paddedHeight,
+		GL_RGBA, GL_UNSIGNED_BYTE, padded.data());
+
+	AtlasRegion region;
+	region.texture = pages[page].ID;
+	region.page = page;
+	region.rect = { placed.x + padding, placed.y + padding, width, height };
+	// row 0 is the top of the image, and sprite.frag samples with t flipped
+	GLfloat size = (GLfloat)pageSize;
+	region.uv.u0 = region.rect.x / size;
+	region.uv.u1 = (region.rect.x + width) / size;
+	region.uv.v0 = 1.0f - (region.rect.y + height) / size;
+	region.uv.v1 = 1.0f - region.rect.y / size;
+	// an image already under this name only gives its space up once the new one has a place
+	Evict(name);
+	regions[Names::Intern(name)] = region;
+	return true;
+}
+
+const AtlasRegion *Atlas::Find(const std::string &name) const {
+	auto found = regions.find(Names::Intern(name));
+	return found == regions.end() ? NULL : &found->second;
+}
+
+void Atlas::Evict(const std::string &name) {
+	auto found = regions.find(Names::Intern(name));
+	if (found == regions.end()) {
+		return;
+	}
+	const AtlasRegion &region = found->second;
+	RectPacker::Rect padded = { region.rect.x - padding, region.rect.y - padding,
+		region.rect.width + padding * 2, region.rect.height + padding * 2 };
+	packers[region.page].Free(padded);
+	regions.erase(found);
+}
+
+Atlas::Stats Atlas::GetStats() const {
+	Stats stats = {};
+	stats.images = (int)regions.size();
+	stats.pages = (int)pages.size();
+	for (const RectPacker &packer : packers) {
+		stats.occupancy += packer.Occupancy();
+	}
+	if (!packers.empty()) {
+		stats.occupancy /= packers.size();
+	}
+	return stats;
+}
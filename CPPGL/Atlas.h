@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Names.h"
+#include "RectPacker.h"
+#include "SpriteBatch.h"
+#include "Texture.h"
+
+// where one image ended up in an atlas
+struct AtlasRegion {
+	// the page texture, what SpriteBatch::Draw takes
+	GLuint texture;
+	int page;
+	// in the flipped space sprite.frag samples in, so it can go straight to a sprite
+	UVRect uv;
+	// the image's pixels on the page, not counting the padding around it
+	RectPacker::Rect rect;
+};
+
+// packs lots of small images into a few big textures so a whole scene of sprites
+// can draw from them without rebinding. every image gets padding around it
+// filled with copies of its edge pixels, so filtering at the border never picks
+// up a neighbour. pages are added as needed up to maxPages. images can be added
+// at any time and evicted again to make room. pages are NEAREST with no mips,
+// since mips would blend neighbouring images together anyway
+class Atlas {
+public:
+	struct Stats {
+		int images;
+		int pages;
+		// fraction of the used pages' area handed out, padding included
+		float occupancy;
+	};
+
+	std::vector<Texture> pages;
+
+	Atlas(GLsizei pageSize = 2048, GLsizei padding = 1, int maxPages = 8);
+
+	// loads a list of images with stb_image and packs them in one go, biggest
+	// first since that packs tighter. each one is named after its file.
+	// returns how many couldn't be loaded or didn't fit
+	int Pack(const std::vector<std::string> &files);
+	// one rgba image, false if it doesn't fit on any page. adding a name that's
+	// already there replaces the old image, which is kept if the new one doesn't fit
+	bool Insert(const std::string &name, const unsigned char *pixels, GLsizei width, GLsizei height);
+	// NULL if there's no image by that name
+	const AtlasRegion *Find(const std::string &name) const;
+	// frees the image's space, its pixels stay on the page until something is put over them
+	void Evict(const std::string &name);
+
+	Stats GetStats() const;
+
+private:
+	GLsizei pageSize;
+	GLsizei padding;
+	int maxPages;
+	std::vector<RectPacker> packers;
+	std::unordered_map<Names::Id, AtlasRegion> regions;
+};
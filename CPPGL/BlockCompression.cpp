@@ -0,0 +1,771 @@
+#include "BlockCompression.h"
+#include "GLExtensions.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace {
+	typedef unsigned char Block[16][4];
+
+	void loadBlock(const unsigned char *pixels, int width, int height, int blockX, int blockY, Block block) {
+		for (int y = 0; y < 4; y++) {
+			int sourceY = std::min(blockY * 4 + y, height - 1);
+			for (int x = 0; x < 4; x++) {
+				int sourceX = std::min(blockX * 4 + x, width - 1);
+				memcpy(block[y * 4 + x], pixels + ((size_t)sourceY * width + sourceX) * 4, 4);
+			}
+		}
+	}
+
+	void storeBlock(const Block block, int blockX, int blockY, unsigned char *pixels, int width, int height) {
+		for (int y = 0; y < 4 && blockY * 4 + y < height; y++) {
+			for (int x = 0; x < 4 && blockX * 4 + x < width; x++) {
+				memcpy(pixels + ((size_t)(blockY * 4 + y) * width + blockX * 4 + x) * 4, block[y * 4 + x], 4);
+			}
+		}
+	}
+
+	int clampByte(float value) {
+		return value <= 0.0f ? 0 : value >= 255.0f ? 255 : (int)(value + 0.5f);
+	}
+
+	int square(int value) {
+		return value * value;
+	}
+
+	// the line through the points that they spread out along the most: the mean,
+	// and the covariance's biggest eigenvector by power iteration. the ends are
+	// where the furthest points project onto it
+	void fitLine(const float (*points)[4], int count, int channels, float start[4], float end[4]) {
+		float mean[4] = {};
+		for (int i = 0; i < count; i++) {
+			for (int c = 0; c < channels; c++) {
+				mean[c] += points[i][c] / count;
+			}
+		}
+		float covariance[4][4] = {};
+		float low[4] = { 255, 255, 255, 255 };
+		float high[4] = {};
+		for (int i = 0; i < count; i++) {
+			for (int c = 0; c < channels; c++) {
+				for (int d = 0; d < channels; d++) {
+					covariance[c][d] += (points[i][c] - mean[c]) * (points[i][d] - mean[d]);
+				}
+				low[c] = std::min(low[c], points[i][c]);
+				high[c] = std::max(high[c], points[i][c]);
+			}
+		}
+
+		// start from the bounding box diagonal, it's usually close already
+		float axis[4] = {};
+		for (int c = 0; c < channels; c++) {
+			axis[c] = high[c] - low[c];
+		}
+		for (int iteration = 0; iteration < 8; iteration++) {
+			float next[4] = {};
+			float length = 0.0f;
+			for (int c = 0; c < channels; c++) {
+				for (int d = 0; d < channels; d++) {
+					next[c] += covariance[c][d] * axis[d];
+				}
+				length += next[c] * next[c];
+			}
+			if (length < 1e-12f) {
+				break;
+			}
+			length = std::sqrt(length);
+			for (int c = 0; c < channels; c++) {
+				axis[c] = next[c] / length;
+			}
+		}
+
+		float lowT = 0.0f, highT = 0.0f;
+		for (int i = 0; i < count; i++) {
+			float t = 0.0f;
+			for (int c = 0; c < channels; c++) {
+				t += (points[i][c] - mean[c]) * axis[c];
+			}
+			lowT = std::min(lowT, t);
+			highT = std::max(highT, t);
+		}
+		for (int c = 0; c < channels; c++) {
+			start[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * lowT));
+			end[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * highT));
+		}
+	}
+
+	// the endpoints that best fit the points for fixed palette positions, where a
+	// weight of 0 is all start and 1 is all end. false if the weights can't pin
+	// both down (they're all the same)
+	bool leastSquares(const float (*points)[4], const float *weights, int count, int channels,
+		float start[4], float end[4])
+	{
+		double aa = 0.0, ab = 0.0, bb = 0.0;
+		double ax[4] = {}, bx[4] = {};
+		for (int i = 0; i < count; i++) {
+			double b = weights[i];
+			double a = 1.0 - b;
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+			for (int c = 0; c < channels; c++) {
+				ax[c] += a * points[i][c];
+				bx[c] += b * points[i][c];
+			}
+		}
+		double determinant = aa * bb - ab * ab;
+		if (std::fabs(determinant) < 1e-6) {
+			return false;
+		}
+		for (int c = 0; c < channels; c++) {
+			start[c] = (float)std::min(255.0, std::max(0.0, (bb * ax[c] - ab * bx[c]) / determinant));
+			end[c] = (float)std::min(255.0, std::max(0.0, (aa * bx[c] - ab * ax[c]) / determinant));
+		}
+		return true;
+	}
+
+	// BC1
+
+	struct ColorBlock {
+		uint16_t color0;
+		uint16_t color1;
+		uint32_t indices;
+		int error;
+	};
+
+	uint16_t pack565(const float rgb[3]) {
+		int r = clampByte(rgb[0] * 31.0f / 255.0f);
+		int g = clampByte(rgb[1] * 63.0f / 255.0f);
+		int b = clampByte(rgb[2] * 31.0f / 255.0f);
+		return (uint16_t)((r << 11) | (g << 5) | b);
+	}
+
+	void unpack565(uint16_t color, int rgb[3]) {
+		int r = (color >> 11) & 31;
+		int g = (color >> 5) & 63;
+		int b = color & 31;
+		rgb[0] = (r << 3) | (r >> 2);
+		rgb[1] = (g << 2) | (g >> 4);
+		rgb[2] = (b << 3) | (b >> 2);
+	}
+
+	// colour0 > colour1 means four colours, otherwise three and transparent black.
+	// BC3 always decodes four, its alpha is separate
+	int colorPalette(uint16_t color0, uint16_t color1, bool alwaysFour, int palette[4][3]) {
+		unpack565(color0, palette[0]);
+		unpack565(color1, palette[1]);
+		bool four = alwaysFour || color0 > color1;
+		for (int c = 0; c < 3; c++) {
+			if (four) {
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			} else {
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+				palette[3][c] = 0;
+			}
+		}
+		return four ? 4 : 3;
+	}
+
+	// where each palette index sits between colour0 and colour1, for least squares
+	const float FOUR_COLOR_WEIGHTS[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+	const float THREE_COLOR_WEIGHTS[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+	// picks the nearest palette entry for every pixel. with transparent set the
+	// block uses three colour mode so pixels under half alpha can be index 3
+	ColorBlock evaluateColor(const Block block, bool transparent, uint16_t a, uint16_t b) {
+		ColorBlock result;
+		// the order of the endpoints picks the mode, so make it the one we want.
+		// equal endpoints decode as three colours, which is fine with every index 0
+		if (transparent ? a > b : a < b) {
+			std::swap(a, b);
+		}
+		result.color0 = a;
+		result.color1 = b;
+		result.indices = 0;
+		result.error = 0;
+		int palette[4][3];
+		int entries = colorPalette(a, b, false, palette);
+		if (transparent) {
+			entries = 3;
+		} else if (a == b) {
+			entries = 1;
+		}
+		for (int i = 0; i < 16; i++) {
+			if (transparent && block[i][3] < 128) {
+				result.indices |= 3u << (i * 2);
+				continue;
+			}
+			if (block[i][3] == 0) {
+				// nothing shows there, whatever's nearest to nothing will do
+				continue;
+			}
+			int best = 0;
+			int bestError = std::numeric_limits<int>::max();
+			for (int entry = 0; entry < entries; entry++) {
+				int error = square(palette[entry][0] - block[i][0]) + square(palette[entry][1] - block[i][1])
+					+ square(palette[entry][2] - block[i][2]);
+				if (error < bestError) {
+					best = entry;
+					bestError = error;
+				}
+			}
+			result.indices |= (uint32_t)best << (i * 2);
+			result.error += bestError;
+		}
+		return result;
+	}
+
+	void encodeColor(const Block block, BlockCompression::Quality quality, bool allowTransparent,
+		unsigned char *out)
+	{
+		bool transparent = false;
+		float points[16][4];
+		int count = 0;
+		for (int i = 0; i < 16; i++) {
+			if (allowTransparent && block[i][3] < 128) {
+				transparent = true;
+				continue;
+			}
+			if (block[i][3] == 0) {
+				continue;
+			}
+			for (int c = 0; c < 3; c++) {
+				points[count][c] = block[i][c];
+			}
+			count++;
+		}
+
+		ColorBlock best = { 0, 0, 0xFFFFFFFFu, 0 };
+		if (count > 0) {
+			float start[4], end[4];
+			fitLine(points, count, 3, start, end);
+			best = evaluateColor(block, transparent, pack565(start), pack565(end));
+
+			if (quality >= BlockCompression::NORMAL) {
+				for (int iteration = 0; iteration < 2; iteration++) {
+					const float *indexWeights = best.color0 > best.color1 ? FOUR_COLOR_WEIGHTS : THREE_COLOR_WEIGHTS;
+					float weights[16];
+					int point = 0;
+					for (int i = 0; i < 16; i++) {
+						if (!(transparent && block[i][3] < 128) && block[i][3] != 0) {
+							weights[point++] = indexWeights[(best.indices >> (i * 2)) & 3];
+						}
+					}
+					if (!leastSquares(points, weights, count, 3, start, end)) {
+						break;
+					}
+					ColorBlock refined = evaluateColor(block, transparent, pack565(start), pack565(end));
+					if (refined.error >= best.error) {
+						break;
+					}
+					best = refined;
+				}
+			}
+
+			if (quality >= BlockCompression::BEST) {
+				// nudge each 565 channel of each endpoint by one while that helps
+				static const uint16_t steps[3] = { 1 << 11, 1 << 5, 1 };
+				static const uint16_t masks[3] = { 31 << 11, 63 << 5, 31 };
+				bool improved = true;
+				for (int round = 0; improved && round < 16; round++) {
+					improved = false;
+					for (int endpoint = 0; endpoint < 2; endpoint++) {
+						for (int channel = 0; channel < 3; channel++) {
+							for (int direction = -1; direction <= 1; direction += 2) {
+								uint16_t colors[2] = { best.color0, best.color1 };
+								int field = colors[endpoint] & masks[channel];
+								int moved = field + direction * steps[channel];
+								if (moved < 0 || moved > masks[channel]) {
+									continue;
+								}
+								colors[endpoint] = (uint16_t)((colors[endpoint] & ~masks[channel]) | moved);
+								ColorBlock candidate = evaluateColor(block, transparent, colors[0], colors[1]);
+								if (candidate.error < best.error) {
+									best = candidate;
+									improved = true;
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		memcpy(out, &best.color0, 2);
+		memcpy(out + 2, &best.color1, 2);
+		memcpy(out + 4, &best.indices, 4);
+	}
+
+	void decodeColor(const unsigned char *in, bool alwaysFour, Block block) {
+		uint16_t color0, color1;
+		uint32_t indices;
+		memcpy(&color0, in, 2);
+		memcpy(&color1, in + 2, 2);
+		memcpy(&indices, in + 4, 4);
+		int palette[4][3];
+		int entries = colorPalette(color0, color1, alwaysFour, palette);
+		for (int i = 0; i < 16; i++) {
+			int index = (indices >> (i * 2)) & 3;
+			for (int c = 0; c < 3; c++) {
+				block[i][c] = (unsigned char)palette[index][c];
+			}
+			block[i][3] = entries == 3 && index == 3 ? 0 : 255;
+		}
+	}
+
+	// BC3 alpha (the same block as BC4)
+
+	struct AlphaBlock {
+		unsigned char alpha0;
+		unsigned char alpha1;
+		uint64_t indices;
+		int error;
+	};
+
+	// alpha0 > alpha1 means eight steps between them, otherwise six plus 0 and 255
+	void alphaPalette(int alpha0, int alpha1, int palette[8]) {
+		palette[0] = alpha0;
+		palette[1] = alpha1;
+		if (alpha0 > alpha1) {
+			for (int i = 2; i < 8; i++) {
+				palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1 + 3) / 7;
+			}
+		} else {
+			for (int i = 2; i < 6; i++) {
+				palette[i] = ((6 - i) * alpha0 + (i - 1) * alpha1 + 2) / 5;
+			}
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+	}
+
+	AlphaBlock evaluateAlpha(const Block block, int alpha0, int alpha1) {
+		AlphaBlock result = { (unsigned char)alpha0, (unsigned char)alpha1, 0, 0 };
+		int palette[8];
+		alphaPalette(alpha0, alpha1, palette);
+		for (int i = 0; i < 16; i++) {
+			int best = 0;
+			int bestError = std::numeric_limits<int>::max();
+			for (int entry = 0; entry < 8; entry++) {
+				int error = square(palette[entry] - block[i][3]);
+				if (error < bestError) {
+					best = entry;
+					bestError = error;
+				}
+			}
+			result.indices |= (uint64_t)best << (i * 3);
+			result.error += bestError;
+		}
+		return result;
+	}
+
+	// tries every pair within range of the ends, alpha0 kept above alpha1 for eight steps
+	// (or below it for six)
+	AlphaBlock searchAlpha(const Block block, int low, int high, int range, bool sixSteps) {
+		AlphaBlock best = sixSteps ? evaluateAlpha(block, low, high) : evaluateAlpha(block, high, low);
+		for (int lowStep = 0; lowStep <= range; lowStep++) {
+			for (int highStep = 0; highStep <= range; highStep++) {
+				int a = std::min(255, low + lowStep);
+				int b = std::max(0, high - highStep);
+				if (a >= b) {
+					continue;
+				}
+				AlphaBlock candidate = sixSteps ? evaluateAlpha(block, a, b) : evaluateAlpha(block, b, a);
+				if (candidate.error < best.error) {
+					best = candidate;
+				}
+			}
+		}
+		return best;
+	}
+
+	void encodeAlpha(const Block block, BlockCompression::Quality quality, unsigned char *out) {
+		int low = 255, high = 0;
+		int innerLow = 255, innerHigh = 0;
+		for (int i = 0; i < 16; i++) {
+			int alpha = block[i][3];
+			low = std::min(low, alpha);
+			high = std::max(high, alpha);
+			if (alpha != 0 && alpha != 255) {
+				innerLow = std::min(innerLow, alpha);
+				innerHigh = std::max(innerHigh, alpha);
+			}
+		}
+
+		int range = quality == BlockCompression::FAST ? 0 : quality == BlockCompression::NORMAL ? 2 : 6;
+		AlphaBlock best = searchAlpha(block, low, high, range, false);
+		// the six step mode gets 0 and 255 for free, which suits sprite edges
+		if (quality >= BlockCompression::BEST && best.error > 0) {
+			AlphaBlock six = innerLow <= innerHigh
+				? searchAlpha(block, innerLow, innerHigh, range, true)
+				: evaluateAlpha(block, 0, 0);
+			if (six.error < best.error) {
+				best = six;
+			}
+		}
+
+		out[0] = best.alpha0;
+		out[1] = best.alpha1;
+		for (int i = 0; i < 6; i++) {
+			out[2 + i] = (unsigned char)(best.indices >> (i * 8));
+		}
+	}
+
+	void decodeAlpha(const unsigned char *in, Block block) {
+		int palette[8];
+		alphaPalette(in[0], in[1], palette);
+		uint64_t indices = 0;
+		for (int i = 0; i < 6; i++) {
+			indices |= (uint64_t)in[2 + i] << (i * 8);
+		}
+		for (int i = 0; i < 16; i++) {
+			block[i][3] = (unsigned char)palette[(indices >> (i * 3)) & 7];
+		}
+	}
+
+	// BC7, mode 6 only: one pair of rgba endpoints at 7 bits plus a shared low bit
+	// each, and 16 steps between them. a single line through rgba can't do
+	// everything the other seven modes can, but it beats BC3 nearly everywhere
+
+	const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	struct Bc7Block {
+		int endpoints[2][4]; // 7 bits
+		int pbits[2];
+		int indices[16];
+		int error;
+	};
+
+	int bc7Interpolate(int a, int b, int index) {
+		return ((64 - BC7_WEIGHTS[index]) * a + BC7_WEIGHTS[index] * b + 32) >> 6;
+	}
+
+	void bc7Evaluate(const Block block, Bc7Block &result) {
+		int palette[16][4];
+		for (int c = 0; c < 4; c++) {
+			int a = (result.endpoints[0][c] << 1) | result.pbits[0];
+			int b = (result.endpoints[1][c] << 1) | result.pbits[1];
+			for (int index = 0; index < 16; index++) {
+				palette[index][c] = bc7Interpolate(a, b, index);
+			}
+		}
+		result.error = 0;
+		for (int i = 0; i < 16; i++) {
+			int best = 0;
+			int bestError = std::numeric_limits<int>::max();
+			// the colour of a fully transparent pixel never shows, only its alpha counts
+			int colorWeight = block[i][3] != 0 ? 1 : 0;
+			for (int index = 0; index < 16; index++) {
+				int error = colorWeight * (square(palette[index][0] - block[i][0])
+					+ square(palette[index][1] - block[i][1]) + square(palette[index][2] - block[i][2]))
+					+ square(palette[index][3] - block[i][3]);
+				if (error < bestError) {
+					best = index;
+					bestError = error;
+				}
+			}
+			result.indices[i] = best;
+			result.error += bestError;
+		}
+	}
+
+	int quantize7(float value, int pbit) {
+		return std::min(127, std::max(0, (int)std::floor((value - pbit) / 2.0f + 0.5f)));
+	}
+
+	// the p bit that loses the least rounding the endpoint to 7 bits, unless one is forced
+	void bc7Quantize(const float start[4], const float end[4], int forcedPbits, Bc7Block &result) {
+		const float *ends[2] = { start, end };
+		for (int endpoint = 0; endpoint < 2; endpoint++) {
+			int bestPbit = 0;
+			float bestError = std::numeric_limits<float>::max();
+			for (int pbit = 0; pbit < 2; pbit++) {
+				if (forcedPbits >= 0 && pbit != ((forcedPbits >> endpoint) & 1)) {
+					continue;
+				}
+				float error = 0.0f;
+				for (int c = 0; c < 4; c++) {
+					float decoded = (float)((quantize7(ends[endpoint][c], pbit) << 1) | pbit);
+					error += (decoded - ends[endpoint][c]) * (decoded - ends[endpoint][c]);
+				}
+				if (error < bestError) {
+					bestPbit = pbit;
+					bestError = error;
+				}
+			}
+			result.pbits[endpoint] = bestPbit;
+			for (int c = 0; c < 4; c++) {
+				result.endpoints[endpoint][c] = quantize7(ends[endpoint][c], bestPbit);
+			}
+		}
+	}
+
+	void encodeBc7(const Block block, BlockCompression::Quality quality, unsigned char *out) {
+		// fully transparent pixels take the average colour of the rest, so the
+		// line only has to stretch as far as their alpha
+		float average[3] = {};
+		int visible = 0;
+		for (int i = 0; i < 16; i++) {
+			if (block[i][3] != 0) {
+				for (int c = 0; c < 3; c++) {
+					average[c] += block[i][c];
+				}
+				visible++;
+			}
+		}
+		float points[16][4];
+		for (int i = 0; i < 16; i++) {
+			for (int c = 0; c < 3; c++) {
+				points[i][c] = block[i][3] != 0 || visible == 0 ? block[i][c] : average[c] / visible;
+			}
+			points[i][3] = block[i][3];
+		}
+		float start[4], end[4];
+		fitLine(points, 16, 4, start, end);
+		Bc7Block best;
+		bc7Quantize(start, end, -1, best);
+		bc7Evaluate(block, best);
+
+		if (quality >= BlockCompression::NORMAL) {
+			for (int iteration = 0; iteration < 2; iteration++) {
+				float weights[16];
+				for (int i = 0; i < 16; i++) {
+					weights[i] = BC7_WEIGHTS[best.indices[i]] / 64.0f;
+				}
+				if (!leastSquares(points, weights, 16, 4, start, end)) {
+					break;
+				}
+				Bc7Block refined;
+				bc7Quantize(start, end, -1, refined);
+				bc7Evaluate(block, refined);
+				if (refined.error >= best.error) {
+					break;
+				}
+				best = refined;
+			}
+		}
+
+		if (quality >= BlockCompression::BEST) {
+			for (int pbits = 0; pbits < 4; pbits++) {
+				Bc7Block candidate;
+				bc7Quantize(start, end, pbits, candidate);
+				bc7Evaluate(block, candidate);
+				if (candidate.error < best.error) {
+					best = candidate;
+				}
+			}
+			bool improved = true;
+			for (int round = 0; improved && round < 16; round++) {
+				improved = false;
+				for (int endpoint = 0; endpoint < 2; endpoint++) {
+					for (int c = 0; c < 4; c++) {
+						for (int direction = -1; direction <= 1; direction += 2) {
+							Bc7Block candidate = best;
+							int moved = candidate.endpoints[endpoint][c] + direction;
+							if (moved < 0 || moved > 127) {
+								continue;
+							}
+							candidate.endpoints[endpoint][c] = moved;
+							bc7Evaluate(block, candidate);
+							if (candidate.error < best.error) {
+								best = candidate;
+								improved = true;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		// the first index is stored with its top bit implied to be 0, so flip the
+		// block around if it isn't. the weights are symmetric, nothing changes
+		if (best.indices[0] >= 8) {
+			for (int c = 0; c < 4; c++) {
+				std::swap(best.endpoints[0][c], best.endpoints[1][c]);
+			}
+			std::swap(best.pbits[0], best.pbits[1]);
+			for (int i = 0; i < 16; i++) {
+				best.indices[i] = 15 - best.indices[i];
+			}
+		}
+
+		// 128 bits, least significant first: mode (bit 6), r0 r1 g0 g1 b0 b1 a0 a1
+		// at 7 bits each, the two p bits, then the indices
+		uint64_t bits[2] = {};
+		int position = 0;
+		auto write = [&](uint64_t value, int count) {
+			for (int i = 0; i < count; i++, position++) {
+				bits[position / 64] |= ((value >> i) & 1) << (position % 64);
+			}
+		};
+		write(1 << 6, 7);
+		for (int c = 0; c < 4; c++) {
+			write(best.endpoints[0][c], 7);
+			write(best.endpoints[1][c], 7);
+		}
+		write(best.pbits[0], 1);
+		write(best.pbits[1], 1);
+		write(best.indices[0], 3);
+		for (int i = 1; i < 16; i++) {
+			write(best.indices[i], 4);
+		}
+		memcpy(out, bits, 16);
+	}
+
+	void decodeBc7(const unsigned char *in, Block block) {
+		uint64_t bits[2];
+		memcpy(bits, in, 16);
+		int position = 0;
+		auto read = [&](int count) {
+			int value = 0;
+			for (int i = 0; i < count; i++, position++) {
+				value |= (int)((bits[position / 64] >> (position % 64)) & 1) << i;
+			}
+			return value;
+		};
+		if (read(7) != 1 << 6) {
+			// another encoder's block, paint it magenta rather than guess
+			for (int i = 0; i < 16; i++) {
+				block[i][0] = 255;
+				block[i][1] = 0;
+				block[i][2] = 255;
+				block[i][3] = 255;
+			}
+			return;
+		}
+		int endpoints[2][4];
+		for (int c = 0; c < 4; c++) {
+			endpoints[0][c] = read(7);
+			endpoints[1][c] = read(7);
+		}
+		int pbit0 = read(1);
+		int pbit1 = read(1);
+		for (int i = 0; i < 16; i++) {
+			int index = read(i == 0 ? 3 : 4);
+			for (int c = 0; c < 4; c++) {
+				block[i][c] = (unsigned char)bc7Interpolate((endpoints[0][c] << 1) | pbit0,
+					(endpoints[1][c] << 1) | pbit1, index);
+			}
+		}
+	}
+}
+
+namespace BlockCompression {
+	size_t BlockBytes(Format format) {
+		return format == BC1 ? 8 : 16;
+	}
+
+	uint32_t GLFormat(Format format) {
+		switch (format) {
+		case BC1:
+			return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		case BC3:
+			return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		default:
+			return GL_COMPRESSED_RGBA_BPTC_UNORM;
+		}
+	}
+
+	bool FromGLFormat(uint32_t glFormat, Format &format) {
+		for (Format candidate : { BC1, BC3, BC7 }) {
+			if (GLFormat(candidate) == glFormat) {
+				format = candidate;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	size_t LevelBytes(uint32_t glFormat, uint32_t width, uint32_t height) {
+		Format format;
+		if (FromGLFormat(glFormat, format)) {
+			return (size_t)((width + 3) / 4) * ((height + 3) / 4) * BlockBytes(format);
+		}
+		return glFormat == GL_RGBA8 ? (size_t)width * height * 4 : 0;
+	}
+
+	std::vector<unsigned char> Encode(Format format, Quality quality, const unsigned char *pixels,
+		int width, int height, int threads)
+	{
+		int blocksWide = (width + 3) / 4;
+		int blocksHigh = (height + 3) / 4;
+		size_t blockBytes = BlockBytes(format);
+		std::vector<unsigned char> blocks((size_t)blocksWide * blocksHigh * blockBytes);
+
+		// every block is independent, so each thread takes every nth row of them
+		auto encodeRows = [&](int first, int step) {
+			Block block;
+			for (int blockY = first; blockY < blocksHigh; blockY += step) {
+				for (int blockX = 0; blockX < blocksWide; blockX++) {
+					loadBlock(pixels, width, height, blockX, blockY, block);
+					unsigned char *out = &blocks[((size_t)blockY * blocksWide + blockX) * blockBytes];
+					if (format == BC1) {
+						encodeColor(block, quality, true, out);
+					} else if (format == BC3) {
+						encodeAlpha(block, quality, out);
+						encodeColor(block, quality, false, out + 8);
+					} else {
+						encodeBc7(block, quality, out);
+					}
+				}
+			}
+		};
+		if (threads <= 0) {
+			threads = std::max(1, (int)std::thread::hardware_concurrency());
+		}
+		threads = std::min(threads, blocksHigh);
+		std::vector<std::thread> workers;
+		for (int i = 1; i < threads; i++) {
+			workers.emplace_back(encodeRows, i, threads);
+		}
+		encodeRows(0, threads);
+		for (std::thread &worker : workers) {
+			worker.join();
+		}
+		return blocks;
+	}
+
+	std::vector<unsigned char> Decode(Format format, const unsigned char *blocks, int width, int height) {
+		int blocksWide = (width + 3) / 4;
+		int blocksHigh = (height + 3) / 4;
+		size_t blockBytes = BlockBytes(format);
+		std::vector<unsigned char> pixels((size_t)width * height * 4);
+		Block block;
+		for (int blockY = 0; blockY < blocksHigh; blockY++) {
+			for (int blockX = 0; blockX < blocksWide; blockX++) {
+				const unsigned char *in = blocks + ((size_t)blockY * blocksWide + blockX) * blockBytes;
+				if (format == BC1) {
+					decodeColor(in, false, block);
+				} else if (format == BC3) {
+					decodeColor(in + 8, true, block);
+					decodeAlpha(in, block);
+				} else {
+					decodeBc7(in, block);
+				}
+				storeBlock(block, blockX, blockY, pixels.data(), width, height);
+			}
+		}
+		return pixels;
+	}
+
+	double PSNR(const unsigned char *source, const unsigned char *decoded, size_t pixels) {
+		double total = 0.0;
+		size_t samples = 0;
+		for (size_t i = 0; i < pixels * 4; i++) {
+			if (i % 4 != 3 && source[i - i % 4 + 3] == 0) {
+				continue;
+			}
+			double difference = (double)source[i] - decoded[i];
+			total += difference * difference;
+			samples++;
+		}
+		if (total == 0.0) {
+			return std::numeric_limits<double>::infinity();
+		}
+		double mse = total / samples;
+		return 10.0 * std::log10(255.0 * 255.0 / mse);
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// a cpu encoder and decoder for the block compressed formats every desktop GPU
+// samples directly. each 4x4 block of pixels becomes 8 (BC1) or 16 (BC3, BC7)
+// bytes, 8x or 4x smaller than rgba8. no GL calls in here, cppgl_cook uses it
+// offline and the renderer only needs the sizes
+namespace BlockCompression {
+	enum Format {
+		BC1, // DXT1, rgb with 1 bit alpha, 4 bits per pixel
+		BC3, // DXT5, BC1 colour plus a separate 8 bit alpha block, 8 bits per pixel
+		BC7 // 8 bits per pixel like BC3 but far better quality, mode 6 only
+	};
+
+	// how hard the encoder looks for good endpoints. FAST fits a line through the
+	// block's colours, NORMAL refines it with least squares, BEST then searches
+	// the neighbouring quantized endpoints as well
+	enum Quality {
+		FAST,
+		NORMAL,
+		BEST
+	};
+
+	size_t BlockBytes(Format format);
+	// the GL internal format to upload it as
+	uint32_t GLFormat(Format format);
+	// false if glFormat isn't one of the three
+	bool FromGLFormat(uint32_t glFormat, Format &format);
+	// what one mip level takes in a GL internal format, block compressed or
+	// GL_RGBA8. 0 for anything else
+	size_t LevelBytes(uint32_t glFormat, uint32_t width, uint32_t height);
+
+	// tightly packed rgba in, whole blocks out, left to right then top to bottom.
+	// blocks hanging off the right or bottom edge repeat the last column or row.
+	// threads 0 means one per core
+	std::vector<unsigned char> Encode(Format format, Quality quality, const unsigned char *pixels,
+		int width, int height, int threads = 0);
+	// back to tightly packed rgba, to check what the encoder did
+	std::vector<unsigned char> Decode(Format format, const unsigned char *blocks, int width, int height);
+	// peak signal to noise ratio in dB over all four channels, infinite if they
+	// match. the colour of fully transparent source pixels doesn't count, the
+	// encoder doesn't try to keep it either
+	double PSNR(const unsigned char *source, const unsigned char *decoded, size_t pixels);
+}
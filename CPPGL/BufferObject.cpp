@@ -0,0 +1,108 @@
+#include "BufferObject.h"
+#include "GLObjects.h"
+#include "GLState.h"
+#include <cstddef>
+
+BufferObject::BufferObject(GLenum bufferTarget, const void *data, GLsizeiptr bytes, GLenum bufferUsage)
+	: target(bufferTarget), usage(bufferUsage), size(bytes), capacity(bytes)
+{
+	glGenBuffers(1, &ID);
+	// bound to its real target on purpose, an EBO made while a VAO is bound belongs to it
+	GLState::BindBuffer(target, ID);
+	glBufferData(target, bytes, data, usage);
+	GLObjects::Created(GLObjects::BUFFER, ID, bytes);
+}
+
+BufferObject::~BufferObject() {
+	Delete();
+}
+
+// moves just take the ID, the other side is left empty so its destructor does nothing
+BufferObject::BufferObject(BufferObject &&other) noexcept
+	: ID(other.ID), target(other.target), usage(other.usage), size(other.size), capacity(other.capacity)
+{
+	other.ID = 0;
+	other.size = 0;
+	other.capacity = 0;
+}
+
+BufferObject &BufferObject::operator=(BufferObject &&other) noexcept {
+	if (this != &other) {
+		Delete();
+		ID = other.ID;
+		target = other.target;
+		usage = other.usage;
+		size = other.size;
+		capacity = other.capacity;
+		other.ID = 0;
+		other.size = 0;
+		other.capacity = 0;
+	}
+	return *this;
+}
+
+void BufferObject::Update(GLintptr offset, const void *data, GLsizeiptr bytes) {
+	if (offset + bytes > size) {
+		Resize(offset + bytes);
+	}
+	GLState::BindBuffer(GL_COPY_WRITE_BUFFER, ID);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, offset, bytes, data);
+}
+
+void BufferObject::Reserve(GLsizeiptr newCapacity) {
+	if (newCapacity <= capacity) {
+		return;
+	}
+
+	// glBufferData throws the old contents away, so park them in a scratch buffer
+	// on the GPU first and copy them back into the new storage afterwards
+	GLuint scratch = 0;
+	if (size > 0) {
+		glGenBuffers(1, &scratch);
+		GLState::BindBuffer(GL_COPY_WRITE_BUFFER, scratch);
+		glBufferData(GL_COPY_WRITE_BUFFER, size, NULL, GL_STREAM_COPY);
+		GLState::BindBuffer(GL_COPY_READ_BUFFER, ID);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, size);
+	}
+
+	GLState::BindBuffer(GL_COPY_WRITE_BUFFER, ID);
+	glBufferData(GL_COPY_WRITE_BUFFER, newCapacity, NULL, usage);
+	capacity = newCapacity;
+	GLObjects::Resized(GLObjects::BUFFER, ID, capacity);
+
+	if (scratch != 0) {
+		GLState::BindBuffer(GL_COPY_READ_BUFFER, scratch);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, size);
+		glDeleteBuffers(1, &scratch);
+		GLState::BufferDeleted(scratch);
+	}
+}
+
+void BufferObject::Resize(GLsizeiptr newSize) {
+	if (newSize > capacity) {
+		// geometric growth so a buffer that keeps growing only reallocates log(n) times
+		GLsizeiptr grown = capacity * 2;
+		Reserve(newSize > grown ? newSize : grown);
+	}
+	size = newSize;
+}
+
+void BufferObject::Bind() {
+	GLState::BindBuffer(target, ID);
+}
+
+void BufferObject::Unbind() {
+	GLState::BindBuffer(target, 0);
+}
+
+void BufferObject::Delete() {
+	if (ID == 0) {
+		return;
+	}
+	glDeleteBuffers(1, &ID);
+	GLState::BufferDeleted(ID);
+	GLObjects::Deleted(GLObjects::BUFFER, ID);
+	ID = 0;
+	size = 0;
+	capacity = 0;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// what VBO and EBO have in common: a GL buffer that knows how big it is and
+// can be patched or grown after it's made. data changes go through the copy
+// targets, so updating an EBO never disturbs whichever VAO happens to be bound,
+// and growing keeps the same ID so VAOs pointing at it stay valid.
+// the buffer is freed when the object goes out of scope. it can be moved (into a
+// std::vector, out of a function) but not copied, since two copies would both
+// delete the same buffer. a moved-from buffer has ID 0 and frees nothing
+class BufferObject {
+public:
+	GLuint ID;
+	// GL_ARRAY_BUFFER for a VBO, GL_ELEMENT_ARRAY_BUFFER for an EBO
+	GLenum target;
+	// GL_STATIC_DRAW, GL_DYNAMIC_DRAW or GL_STREAM_DRAW, kept for reallocations
+	GLenum usage;
+	// bytes in use, and bytes actually allocated
+	GLsizeiptr size;
+	GLsizeiptr capacity;
+
+	// write size bytes at offset, growing the buffer first if they don't fit
+	void Update(GLintptr offset, const void *data, GLsizeiptr size);
+	// make sure at least capacity bytes are allocated, keeping the contents
+	void Reserve(GLsizeiptr capacity);
+	// change how many bytes are in use, growing past capacity at least doubles it
+	void Resize(GLsizeiptr size);
+
+	void Bind();
+	void Unbind();
+	// frees the buffer early, the destructor does it otherwise
+	void Delete();
+
+	~BufferObject();
+	BufferObject(BufferObject &&other) noexcept;
+	BufferObject &operator=(BufferObject &&other) noexcept;
+	BufferObject(const BufferObject &) = delete;
+	BufferObject &operator=(const BufferObject &) = delete;
+
+protected:
+	BufferObject(GLenum target, const void *data, GLsizeiptr size, GLenum usage);
+};
@@ -0,0 +1,167 @@
+#include "CookedTexture.h"
+#include <glad/glad.h>
+#include "stb/stb_image.h"
+#include "Timing.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace {
+	const uint64_t ALIGNMENT = 16;
+
+	uint64_t alignUp(uint64_t value) {
+		return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	}
+
+	void premultiply(std::vector<unsigned char> &pixels) {
+		for (size_t i = 0; i < pixels.size(); i += 4) {
+			unsigned int alpha = pixels[i + 3];
+			for (int c = 0; c < 3; c++) {
+				// rounded, so 255 alpha leaves the colour exactly as it was
+				pixels[i + c] = (unsigned char)((pixels[i + c] * alpha + 127) / 255);
+			}
+		}
+	}
+}
+
+namespace CookedTexture {
+	bool Cook(const char *input, const char *output, const Options &options, Report *report) {
+		int width, height, channels;
+		unsigned char *pixels = stbi_load(input, &width, &height, &channels, 4);
+		if (pixels == NULL) {
+			std::cout << "couldn't load " << input << ": " << stbi_failure_reason() << std::endl;
+			return false;
+		}
+		bool written = Write(output, pixels, width, height, options, report);
+		stbi_image_free(pixels);
+		return written;
+	}
+
+	bool Write(const char *output, const unsigned char *pixels, int width, int height, const Options &options,
+		Report *report)
+	{
+		if (width <= 0 || height <= 0) {
+			std::cout << "can't cook an empty image into " << output << std::endl;
+			return false;
+		}
+		uint32_t fullChain = 1;
+		for (int size = width > height ? width : height; size > 1; size >>= 1) {
+			fullChain++;
+		}
+		if (fullChain > MAX_LEVELS) {
+			std::cout << "can't cook " << output << ", " << width << "x" << height << " is too big" << std::endl;
+			return false;
+		}
+
+		Header header = {};
+		memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.width = (uint32_t)width;
+		header.height = (uint32_t)height;
+		header.levels = options.levels > 0 && (uint32_t)options.levels < fullChain ? (uint32_t)options.levels : fullChain;
+		header.format = options.compress ? BlockCompression::GLFormat(options.compression) : GL_RGBA8;
+		header.flags = options.premultiply ? (uint32_t)PREMULTIPLIED : 0;
+
+		std::vector<std::vector<unsigned char>> images(header.levels);
+		images[0].assign(pixels, pixels + (size_t)width * height * 4);
+		if (options.premultiply) {
+			premultiply(images[0]);
+		}
+		std::vector<MipGenerator::Level> mips;
+		if (header.levels > 1) {
+			MipGenerator::Options mipOptions = options.mips;
+			mipOptions.premultiplied = options.premultiply;
+			mipOptions.levels = (int)header.levels - 1;
+			mips = MipGenerator::Generate(images[0].data(), width, height, mipOptions);
+		}
+
+		std::vector<Level> levels(header.levels);
+		for (uint32_t i = 0; i < header.levels; i++) {
+			levels[i].width = width >> i > 0 ? width >> i : 1;
+			levels[i].height = height >> i > 0 ? height >> i : 1;
+			if (i > 0) {
+				images[i].swap(mips[i - 1].pixels);
+			}
+		}
+
+		// every level is built from the uncompressed one above it, not from
+		// blocks, so the errors don't pile up down the chain
+		double psnr = std::numeric_limits<double>::infinity();
+		auto start = std::chrono::steady_clock::now();
+		if (options.compress) {
+			std::vector<std::vector<unsigned char>> blocks(header.levels);
+			for (uint32_t i = 0; i < header.levels; i++) {
+				blocks[i] = BlockCompression::Encode(options.compression, options.quality, images[i].data(),
+					levels[i].width, levels[i].height);
+			}
+			std::vector<unsigned char> decoded = BlockCompression::Decode(options.compression, blocks[0].data(),
+				width, height);
+			psnr = BlockCompression::PSNR(images[0].data(), decoded.data(), (size_t)width * height);
+			images.swap(blocks);
+		}
+		double encodeMs = millisecondsSince(start);
+
+		uint64_t offset = alignUp(sizeof(Header) + sizeof(Level) * header.levels);
+		for (uint32_t i = 0; i < header.levels; i++) {
+			levels[i].offset = offset;
+			levels[i].size = images[i].size();
+			offset = alignUp(offset + levels[i].size);
+		}
+
+		std::ofstream out(output, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			std::cout << "couldn't write " << output << std::endl;
+			return false;
+		}
+		const char padding[ALIGNMENT] = {};
+		out.write((const char*)&header, sizeof(header));
+		out.write((const char*)levels.data(), sizeof(Level) * levels.size());
+		uint64_t position = sizeof(Header) + sizeof(Level) * levels.size();
+		for (uint32_t i = 0; i < header.levels; i++) {
+			out.write(padding, (std::streamsize)(levels[i].offset - position));
+			out.write((const char*)images[i].data(), (std::streamsize)levels[i].size);
+			position = levels[i].offset + levels[i].size;
+		}
+		if (!out) {
+			std::cout << "couldn't write " << output << std::endl;
+			return false;
+		}
+		if (report != NULL) {
+			report->bytes = offset;
+			report->psnr = psnr;
+			report->encodeMs = encodeMs;
+		}
+		return true;
+	}
+
+	bool Parse(const unsigned char *bytes, size_t size, View &view) {
+		if (bytes == NULL || size < sizeof(Header)) {
+			return false;
+		}
+		const Header *header = (const Header*)bytes;
+		if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION
+			|| header->levels == 0 || header->levels > MAX_LEVELS
+			|| size < sizeof(Header) + sizeof(Level) * header->levels) {
+			return false;
+		}
+		const Level *levels = (const Level*)(bytes + sizeof(Header));
+		for (uint32_t i = 0; i < header->levels; i++) {
+			if (levels[i].offset > size || levels[i].size > size - levels[i].offset) {
+				return false;
+			}
+			// the upload reads what the format says the level takes, whatever the table says.
+			// 0 is a format this build doesn't know
+			size_t needed = BlockCompression::LevelBytes(header->format, levels[i].width, levels[i].height);
+			if (needed == 0 || levels[i].size < needed) {
+				return false;
+			}
+		}
+		view.header = header;
+		view.levels = levels;
+		view.bytes = bytes;
+		return true;
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "BlockCompression.h"
+#include "MipGenerator.h"
+
+// the .ctex files cppgl_cook writes: a header, a table of mip levels, then each
+// level's pixels (or blocks) exactly as glTexImage2D (or glCompressedTexImage2D)
+// wants them, so loading one is a map and an upload with no decoding and no
+// glGenerateMipmap. everything is little endian, and every level starts on a
+// 16 byte boundary
+namespace CookedTexture {
+	// bump VERSION whenever the layout changes
+	const char MAGIC[4] = { 'C', 'T', 'E', 'X' };
+	const uint32_t VERSION = 1;
+	// enough for a 32768 square
+	const uint32_t MAX_LEVELS = 16;
+
+	enum Flags : uint32_t {
+		// rgb has already been multiplied by alpha, blend with GL_ONE, GL_ONE_MINUS_SRC_ALPHA
+		PREMULTIPLIED = 1
+	};
+
+	struct Header {
+		char magic[4];
+		uint32_t version;
+		uint32_t width;
+		uint32_t height;
+		uint32_t levels;
+		// the GL internal format: GL_RGBA8 for plain pixels, or one of the block
+		// compressed formats BlockCompression::GLFormat gives
+		uint32_t format;
+		uint32_t flags;
+		uint32_t reserved;
+	};
+
+	// the table of these follows the header, largest level first
+	struct Level {
+		uint32_t width;
+		uint32_t height;
+		// from the start of the file
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	struct Options {
+		bool premultiply = false;
+		// 0 means the full chain down to 1x1
+		int levels = 0;
+		// plain rgba8 unless this is set
+		bool compress = false;
+		BlockCompression::Format compression = BlockCompression::BC7;
+		BlockCompression::Quality quality = BlockCompression::NORMAL;
+		// how the levels below the base are filtered. premultiplied and levels
+		// are set from the fields above
+		MipGenerator::Options mips;
+	};
+
+	// what Write ended up with
+	struct Report {
+		uint64_t bytes;
+		// the largest level decoded again and compared with what went in,
+		// infinite when it isn't compressed
+		double psnr;
+		double encodeMs;
+	};
+
+	// a checked file, pointing into bytes the caller keeps alive
+	struct View {
+		const Header *header;
+		const Level *levels;
+		const unsigned char *bytes;
+
+		const unsigned char *Pixels(uint32_t level) const { return bytes + levels[level].offset; }
+	};
+
+	// decodes any image stb_image reads and writes it cooked. prints why if it can't
+	bool Cook(const char *input, const char *output, const Options &options, Report *report = NULL);
+	// the same from tightly packed rgba pixels, the mips are built here
+	bool Write(const char *output, const unsigned char *pixels, int width, int height, const Options &options,
+		Report *report = NULL);
+	// false if it isn't a cooked texture this version can read, or it's been cut short
+	bool Parse(const unsigned char *bytes, size_t size, View &view);
+}
@@ -1,19 +1,6 @@
 #include"EBO.h"
 
-EBO::EBO(GLuint *indices, GLsizeiptr size) {
-	glGenBuffers(1, &ID);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices, GL_STATIC_DRAW);
-}
-
-void EBO::Bind() {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
-}
-
-void EBO::Unbind() {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-}
-
-void EBO::Delete() {
-	glDeleteBuffers(1, &ID);
+EBO::EBO(const GLuint *indices, GLsizeiptr size, GLenum usage)
+	: BufferObject(GL_ELEMENT_ARRAY_BUFFER, indices, size, usage)
+{
 }
\ No newline at end of file
@@ -1,19 +1,12 @@
 #pragma once
 
 #include<glad/glad.h>
+#include"BufferObject.h"
 
-class EBO
+class EBO : public BufferObject
 {
 public:
-	// ID reference of Elements Buffer Object
-	GLuint ID;
 	// Constructor that generates a Elements Buffer Object and links it to indices
-	EBO(GLuint* indices, GLsizeiptr size);
-
-	// Binds the EBO
-	void Bind();
-	// Unbinds the EBO
-	void Unbind();
-	// Deletes the EBO
-	void Delete();
-};
+	// (and to the bound VAO, so bind that first)
+	EBO(const GLuint* indices, GLsizeiptr size, GLenum usage = GL_STATIC_DRAW);
+};
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "GLExtensions.h"
+#include <cstring>
+
+PFNGLGETPROGRAMBINARYPROC glad_glGetProgramBinary = NULL;
+PFNGLPROGRAMBINARYPROC glad_glProgramBinary = NULL;
+PFNGLPROGRAMPARAMETERIPROC glad_glProgramParameteri = NULL;
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glad_glMaxShaderCompilerThreadsKHR = NULL;
+PFNGLBUFFERSTORAGEPROC glad_glBufferStorage = NULL;
+PFNGLCOPYIMAGESUBDATAPROC glad_glCopyImageSubData = NULL;
+
+bool GLExtensions::ARB_get_program_binary = false;
+bool GLExtensions::parallel_shader_compile = false;
+bool GLExtensions::ARB_buffer_storage = false;
+bool GLExtensions::ARB_copy_image = false;
+bool GLExtensions::texture_filter_anisotropic = false;
+bool GLExtensions::EXT_texture_compression_s3tc = false;
+bool GLExtensions::texture_compression_bptc = false;
+
+bool GLExtensions::Has(const char *extension) {
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for (GLint i = 0; i < count; i++) {
+		const char *name = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+		if (name != NULL && strcmp(name, extension) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+int GLExtensions::Version() {
+	GLint major = 0, minor = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &major);
+	glGetIntegerv(GL_MINOR_VERSION, &minor);
+	return major * 10 + minor;
+}
+
+void GLExtensions::Load(GLADloadproc load) {
+	int version = Version();
+
+	// core in 4.1
+	if (version >= 41 || Has("GL_ARB_get_program_binary")) {
+		glad_glGetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)load("glGetProgramBinary");
+		glad_glProgramBinary = (PFNGLPROGRAMBINARYPROC)load("glProgramBinary");
+		glad_glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)load("glProgramParameteri");
+		ARB_get_program_binary = glad_glGetProgramBinary != NULL && glad_glProgramBinary != NULL
+			&& glad_glProgramParameteri != NULL;
+	}
+
+	if (Has("GL_KHR_parallel_shader_compile")) {
+		glad_glMaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)load("glMaxShaderCompilerThreadsKHR");
+	} else if (Has("GL_ARB_parallel_shader_compile")) {
+		glad_glMaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)load("glMaxShaderCompilerThreadsARB");
+	}
+	parallel_shader_compile = glad_glMaxShaderCompilerThreadsKHR != NULL;
+	if (parallel_shader_compile) {
+		// 0xFFFFFFFF lets the driver use as many threads as it likes
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+	}
+
+	// core in 4.4
+	if (version >= 44 || Has("GL_ARB_buffer_storage")) {
+		glad_glBufferStorage = (PFNGLBUFFERSTORAGEPROC)load("glBufferStorage");
+		ARB_buffer_storage = glad_glBufferStorage != NULL;
+	}
+
+	// core in 4.3
+	if (version >= 43 || Has("GL_ARB_copy_image")) {
+		glad_glCopyImageSubData = (PFNGLCOPYIMAGESUBDATAPROC)load("glCopyImageSubData");
+		ARB_copy_image = glad_glCopyImageSubData != NULL;
+	}
+
+	texture_filter_anisotropic = version >= 46 || Has("GL_ARB_texture_filter_anisotropic")
+		|| Has("GL_EXT_texture_filter_anisotropic");
+
+	EXT_texture_compression_s3tc = Has("GL_EXT_texture_compression_s3tc");
+	texture_compression_bptc = version >= 42 || Has("GL_ARB_texture_compression_bptc");
+}
@@ -0,0 +1,63 @@
+#include "GLObjects.h"
+#include <cstdio>
+#include <unordered_map>
+
+namespace {
+	const char *kindNames[] = { "buffer", "vertex array", "program", "texture", "sampler" };
+	const int KIND_COUNT = sizeof(kindNames) / sizeof(kindNames[0]);
+
+	// one map per kind since GL hands out IDs per kind, buffer 1 and texture 1 can both exist
+	std::unordered_map<GLuint, size_t> live[KIND_COUNT];
+	size_t totals[KIND_COUNT];
+}
+
+namespace GLObjects {
+	void Created(Kind kind, GLuint id, size_t bytes) {
+		if (id != 0) {
+			size_t &entry = live[kind][id];
+			totals[kind] += bytes - entry;
+			entry = bytes;
+		}
+	}
+
+	void Resized(Kind kind, GLuint id, size_t bytes) {
+		auto found = live[kind].find(id);
+		if (found != live[kind].end()) {
+			totals[kind] += bytes - found->second;
+			found->second = bytes;
+		}
+	}
+
+	void Deleted(Kind kind, GLuint id) {
+		auto found = live[kind].find(id);
+		if (found != live[kind].end()) {
+			totals[kind] -= found->second;
+			live[kind].erase(found);
+		}
+	}
+
+	size_t Bytes(Kind kind) {
+		return totals[kind];
+	}
+
+	size_t Count(Kind kind) {
+		return live[kind].size();
+	}
+
+#ifdef CPPGL_TRACK_OBJECTS
+	void ReportLeaks() {
+		size_t count = 0;
+		size_t total = 0;
+		for (int kind = 0; kind < KIND_COUNT; kind++) {
+			for (const auto &object : live[kind]) {
+				printf("leaked %s %u (%zu bytes)\n", kindNames[kind], object.first, object.second);
+				count++;
+				total += object.second;
+			}
+		}
+		if (count > 0) {
+			printf("%zu GL objects leaked, %.2f MB\n", count, total / (1024.0 * 1024.0));
+		}
+	}
+#endif
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+
+// a list of every live GL object the handle classes own and what it holds on
+// the GPU, so there are running totals to budget against (see TextureResidency).
+// debug builds can also report whatever is still alive at shutdown as a leak,
+// release builds (NDEBUG, or msvc without _DEBUG) compile that part away
+#if !defined(NDEBUG) && (defined(_DEBUG) || !defined(_MSC_VER))
+#define CPPGL_TRACK_OBJECTS 1
+#endif
+
+namespace GLObjects {
+	enum Kind {
+		BUFFER,
+		VERTEX_ARRAY,
+		PROGRAM,
+		TEXTURE,
+		SAMPLER
+	};
+
+	// bytes is what the object holds on the GPU, 0 when we can't tell
+	void Created(Kind kind, GLuint id, size_t bytes);
+	void Resized(Kind kind, GLuint id, size_t bytes);
+	void Deleted(Kind kind, GLuint id);
+	// totals over everything of that kind alive right now
+	size_t Bytes(Kind kind);
+	size_t Count(Kind kind);
+
+#ifdef CPPGL_TRACK_OBJECTS
+	// prints everything still alive with its size, or nothing if it's all been freed.
+	// call it after the last handle is gone but before the context is
+	void ReportLeaks();
+#else
+	inline void ReportLeaks() {}
+#endif
+}
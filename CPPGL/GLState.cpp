@@ -0,0 +1,287 @@
+#include "GLState.h"
+#include <unordered_map>
+
+namespace {
+	// marks a binding we don't know, so the next bind always goes through
+	const GLuint UNKNOWN = 0xFFFFFFFFu;
+	const int MAX_TEXTURE_UNITS = 32;
+
+	// the texture targets we keep per unit, anything else is passed straight through
+	const GLenum textureTargets[] = {
+		GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_3D, GL_TEXTURE_CUBE_MAP
+	};
+	const int TEXTURE_TARGET_COUNT = sizeof(textureTargets) / sizeof(textureTargets[0]);
+
+	// non-VAO buffer targets we keep
+	const GLenum bufferTargets[] = {
+		GL_ARRAY_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+		GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER, GL_UNIFORM_BUFFER,
+		GL_TEXTURE_BUFFER, GL_TRANSFORM_FEEDBACK_BUFFER
+	};
+	const int BUFFER_TARGET_COUNT = sizeof(bufferTargets) / sizeof(bufferTargets[0]);
+	// the least GL_MAX_UNIFORM_BUFFER_BINDINGS can be
+	const int MAX_UNIFORM_BINDINGS = 36;
+
+	// a range bound to an indexed binding point, size 0 for the whole buffer
+	struct IndexedBinding {
+		GLuint buffer = 0;
+		GLintptr offset = 0;
+		GLsizeiptr size = 0;
+	};
+
+	struct State {
+		GLuint program = 0;
+		GLuint vao = 0;
+		GLuint buffers[BUFFER_TARGET_COUNT] = {};
+		// element array buffer bound inside each VAO we've seen
+		std::unordered_map<GLuint, GLuint> elementBuffers;
+		GLuint activeUnit = 0;
+		GLuint textures[MAX_TEXTURE_UNITS][TEXTURE_TARGET_COUNT] = {};
+		GLuint samplers[MAX_TEXTURE_UNITS] = {};
+		IndexedBinding uniformBuffers[MAX_UNIFORM_BINDINGS];
+	};
+
+	State state;
+	GLState::Counters counters = { 0, 0 };
+
+	int textureTargetIndex(GLenum target) {
+		for (int i = 0; i < TEXTURE_TARGET_COUNT; i++) {
+			if (textureTargets[i] == target) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	int bufferTargetIndex(GLenum target) {
+		for (int i = 0; i < BUFFER_TARGET_COUNT; i++) {
+			if (bufferTargets[i] == target) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	// returns true if the caller should issue the GL call, updating the cache either way
+	bool changes(GLuint &cached, GLuint value) {
+		if (cached == value) {
+			counters.skipped++;
+			return false;
+		}
+		cached = value;
+		counters.issued++;
+		return true;
+	}
+
+	GLuint &elementBufferOf(GLuint vao) {
+		auto it = state.elementBuffers.find(vao);
+		if (it == state.elementBuffers.end()) {
+			// a VAO that wasn't announced through VertexArrayCreated could have anything in it
+			it = state.elementBuffers.emplace(vao, UNKNOWN).first;
+		}
+		return it->second;
+	}
+}
+
+void GLState::UseProgram(GLuint program) {
+	if (changes(state.program, program)) {
+		glUseProgram(program);
+	}
+}
+
+void GLState::BindVertexArray(GLuint vao) {
+	if (changes(state.vao, vao)) {
+		glBindVertexArray(vao);
+	}
+}
+
+void GLState::BindBuffer(GLenum target, GLuint buffer) {
+	if (target == GL_ELEMENT_ARRAY_BUFFER) {
+		if (changes(elementBufferOf(state.vao), buffer)) {
+			glBindBuffer(target, buffer);
+		}
+		return;
+	}
+	int index = bufferTargetIndex(target);
+	if (index < 0) {
+		counters.issued++;
+		glBindBuffer(target, buffer);
+		return;
+	}
+	if (changes(state.buffers[index], buffer)) {
+		glBindBuffer(target, buffer);
+	}
+}
+
+void GLState::BindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+	BindBufferRange(target, index, buffer, 0, 0);
+}
+
+void GLState::BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+	if (target != GL_UNIFORM_BUFFER || index >= MAX_UNIFORM_BINDINGS) {
+		counters.issued++;
+		if (size == 0) {
+			glBindBufferBase(target, index, buffer);
+		} else {
+			glBindBufferRange(target, index, buffer, offset, size);
+		}
+		// the indexed binds move the generic binding too
+		int generic = bufferTargetIndex(target);
+		if (generic >= 0) {
+			state.buffers[generic] = buffer;
+		}
+		return;
+	}
+	IndexedBinding &bound = state.uniformBuffers[index];
+	if (bound.buffer == buffer && bound.offset == offset && bound.size == size) {
+		counters.skipped++;
+		return;
+	}
+	bound.buffer = buffer;
+	bound.offset = offset;
+	bound.size = size;
+	counters.issued++;
+	if (size == 0) {
+		glBindBufferBase(target, index, buffer);
+	} else {
+		glBindBufferRange(target, index, buffer, offset, size);
+	}
+	state.buffers[bufferTargetIndex(GL_UNIFORM_BUFFER)] = buffer;
+}
+
+void GLState::ActiveTexture(GLuint unit) {
+	if (changes(state.activeUnit, unit)) {
+		glActiveTexture(GL_TEXTURE0 + unit);
+	}
+}
+
+void GLState::BindTexture(GLenum target, GLuint texture) {
+	int index = textureTargetIndex(target);
+	if (index < 0 || state.activeUnit >= MAX_TEXTURE_UNITS) {
+		counters.issued++;
+		glBindTexture(target, texture);
+		return;
+	}
+	if (changes(state.textures[state.activeUnit][index], texture)) {
+		glBindTexture(target, texture);
+	}
+}
+
+void GLState::BindTexture(GLuint unit, GLenum target, GLuint texture) {
+	int index = textureTargetIndex(target);
+	if (index >= 0 && unit < MAX_TEXTURE_UNITS && state.textures[unit][index] == texture) {
+		counters.skipped++;
+		return;
+	}
+	ActiveTexture(unit);
+	BindTexture(target, texture);
+}
+
+void GLState::BindSampler(GLuint unit, GLuint sampler) {
+	if (unit >= MAX_TEXTURE_UNITS) {
+		counters.issued++;
+		glBindSampler(unit, sampler);
+		return;
+	}
+	if (changes(state.samplers[unit], sampler)) {
+		glBindSampler(unit, sampler);
+	}
+}
+
+void GLState::VertexArrayCreated(GLuint vao) {
+	state.elementBuffers[vao] = 0;
+}
+
+void GLState::BufferDeleted(GLuint buffer) {
+	if (buffer == 0) {
+		return;
+	}
+	for (GLuint &bound : state.buffers) {
+		if (bound == buffer) {
+			bound = 0;
+		}
+	}
+	for (IndexedBinding &bound : state.uniformBuffers) {
+		if (bound.buffer == buffer) {
+			bound = IndexedBinding();
+		}
+	}
+	// GL only unbinds it from the current VAO, other VAOs keep a dangling
+	// reference, so drop those from the cache rather than guess
+	for (auto &entry : state.elementBuffers) {
+		if (entry.second == buffer) {
+			entry.second = entry.first == state.vao ? 0 : UNKNOWN;
+		}
+	}
+}
+
+void GLState::VertexArrayDeleted(GLuint vao) {
+	if (vao == 0) {
+		return;
+	}
+	state.elementBuffers.erase(vao);
+	if (state.vao == vao) {
+		state.vao = 0;
+	}
+}
+
+void GLState::ProgramDeleted(GLuint program) {
+	// a deleted program stays in use until something else is, but its name can
+	// come back from glCreateProgram, so stop trusting the cached one
+	if (program != 0 && state.program == program) {
+		state.program = UNKNOWN;
+	}
+}
+
+void GLState::TextureDeleted(GLuint texture) {
+	if (texture == 0) {
+		return;
+	}
+	for (auto &unit : state.textures) {
+		for (GLuint &bound : unit) {
+			if (bound == texture) {
+				bound = 0;
+			}
+		}
+	}
+}
+
+void GLState::SamplerDeleted(GLuint sampler) {
+	if (sampler == 0) {
+		return;
+	}
+	for (GLuint &bound : state.samplers) {
+		if (bound == sampler) {
+			bound = 0;
+		}
+	}
+}
+
+void GLState::Invalidate() {
+	state.program = UNKNOWN;
+	state.vao = UNKNOWN;
+	for (GLuint &bound : state.buffers) {
+		bound = UNKNOWN;
+	}
+	state.elementBuffers.clear();
+	state.activeUnit = UNKNOWN;
+	for (auto &unit : state.textures) {
+		for (GLuint &bound : unit) {
+			bound = UNKNOWN;
+		}
+	}
+	for (GLuint &bound : state.samplers) {
+		bound = UNKNOWN;
+	}
+	for (IndexedBinding &bound : state.uniformBuffers) {
+		bound.buffer = UNKNOWN;
+	}
+}
+
+GLState::Counters GLState::GetCounters() {
+	return counters;
+}
+
+void GLState::ResetCounters() {
+	counters = { 0, 0 };
+}
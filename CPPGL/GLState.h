@@ -0,0 +1,49 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// shadow copy of the GL binding state, so binding something that's already bound
+// never reaches the driver. everything that binds a program, VAO, buffer or
+// texture should go through here, otherwise call Invalidate() afterwards
+namespace GLState {
+	struct Counters {
+		// binds that actually reached the driver
+		unsigned long long issued;
+		// binds dropped because the object was already bound
+		unsigned long long skipped;
+	};
+
+	void UseProgram(GLuint program);
+	void BindVertexArray(GLuint vao);
+	// the element array binding is remembered per VAO, like GL does
+	void BindBuffer(GLenum target, GLuint buffer);
+	// indexed uniform buffer bindings, kept per binding point. like GL these also
+	// bind the buffer to the plain GL_UNIFORM_BUFFER target. other targets pass through
+	void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+	void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+	// unit is an index, not GL_TEXTURE0 + index
+	void ActiveTexture(GLuint unit);
+	// binds to the currently active unit
+	void BindTexture(GLenum target, GLuint texture);
+	// binds to a specific unit, switching the active unit only if it has to
+	void BindTexture(GLuint unit, GLenum target, GLuint texture);
+	// samplers are bound per unit and don't care which unit is active, 0 goes
+	// back to the texture's own parameters
+	void BindSampler(GLuint unit, GLuint sampler);
+
+	// a fresh VAO has no element buffer, tell the cache so its first bind can be skipped
+	void VertexArrayCreated(GLuint vao);
+
+	// deleting an object implicitly unbinds it in GL, keep the cache in step
+	void BufferDeleted(GLuint buffer);
+	void VertexArrayDeleted(GLuint vao);
+	void ProgramDeleted(GLuint program);
+	void TextureDeleted(GLuint texture);
+	void SamplerDeleted(GLuint sampler);
+
+	// forget everything, e.g. after code that binds things behind our back
+	void Invalidate();
+
+	Counters GetCounters();
+	void ResetCounters();
+}
@@ -0,0 +1,186 @@
+#include "GLStats.h"
+#include "GLExtensions.h"
+
+// every glad entry point the renderer is expected to touch
+// add to this when new code starts calling something else
+#define GLSTATS_FUNCTIONS(X) \
+	X(glActiveTexture) \
+	X(glAttachShader) \
+	X(glBindBuffer) \
+	X(glBindBufferBase) \
+	X(glBindBufferRange) \
+	X(glBindFramebuffer) \
+	X(glBindRenderbuffer) \
+	X(glBindSampler) \
+	X(glBindTexture) \
+	X(glBindVertexArray) \
+	X(glBufferData) \
+	X(glBufferStorage) \
+	X(glBufferSubData) \
+	X(glCheckFramebufferStatus) \
+	X(glClear) \
+	X(glClearColor) \
+	X(glClientWaitSync) \
+	X(glCompileShader) \
+	X(glCompressedTexImage2D) \
+	X(glCopyBufferSubData) \
+	X(glCopyImageSubData) \
+	X(glCreateProgram) \
+	X(glCreateShader) \
+	X(glDeleteBuffers) \
+	X(glDeleteFramebuffers) \
+	X(glDeleteProgram) \
+	X(glDeleteRenderbuffers) \
+	X(glDeleteSamplers) \
+	X(glDeleteShader) \
+	X(glDeleteSync) \
+	X(glDeleteTextures) \
+	X(glDeleteVertexArrays) \
+	X(glDrawElements) \
+	X(glDrawElementsBaseVertex) \
+	X(glDrawElementsInstanced) \
+	X(glEnableVertexAttribArray) \
+	X(glFenceSync) \
+	X(glFinish) \
+	X(glFramebufferRenderbuffer) \
+	X(glGenBuffers) \
+	X(glGenFramebuffers) \
+	X(glGenRenderbuffers) \
+	X(glGenSamplers) \
+	X(glGenTextures) \
+	X(glGenVertexArrays) \
+	X(glGenerateMipmap) \
+	X(glGetActiveAttrib) \
+	X(glGetActiveUniform) \
+	X(glGetActiveUniformBlockName) \
+	X(glGetActiveUniformBlockiv) \
+	X(glGetAttribLocation) \
+	X(glGetFloatv) \
+	X(glGetIntegerv) \
+	X(glGetProgramBinary) \
+	X(glGetProgramInfoLog) \
+	X(glGetProgramiv) \
+	X(glGetShaderInfoLog) \
+	X(glGetShaderiv) \
+	X(glGetString) \
+	X(glGetStringi) \
+	X(glGetTexImage) \
+	X(glGetUniformBlockIndex) \
+	X(glGetUniformLocation) \
+	X(glGetUniformfv) \
+	X(glGetUniformiv) \
+	X(glLinkProgram) \
+	X(glMapBufferRange) \
+	X(glPixelStorei) \
+	X(glProgramBinary) \
+	X(glProgramParameteri) \
+	X(glReadPixels) \
+	X(glRenderbufferStorage) \
+	X(glSamplerParameterf) \
+	X(glSamplerParameteri) \
+	X(glShaderSource) \
+	X(glTexImage2D) \
+	X(glTexImage3D) \
+	X(glTexParameteri) \
+	X(glTexSubImage2D) \
+	X(glTexSubImage3D) \
+	X(glUniform1f) \
+	X(glUniform1fv) \
+	X(glUniform1i) \
+	X(glUniform2f) \
+	X(glUniform2fv) \
+	X(glUniform3f) \
+	X(glUniform3fv) \
+	X(glUniform4f) \
+	X(glUniform4fv) \
+	X(glUniformBlockBinding) \
+	X(glUniformMatrix4fv) \
+	X(glUnmapBuffer) \
+	X(glUseProgram) \
+	X(glVertexAttribDivisor) \
+	X(glVertexAttribPointer) \
+	X(glViewport)
+
+namespace {
+	enum Function {
+#define GLSTATS_ENUM(fn) fn##_index,
+		GLSTATS_FUNCTIONS(GLSTATS_ENUM)
+#undef GLSTATS_ENUM
+		FUNCTION_COUNT
+	};
+
+	const char *names[FUNCTION_COUNT] = {
+#define GLSTATS_NAME(fn) #fn,
+		GLSTATS_FUNCTIONS(GLSTATS_NAME)
+#undef GLSTATS_NAME
+	};
+
+	unsigned long long counts[FUNCTION_COUNT];
+	bool installed = false;
+
+	// one of these gets stamped out per glad pointer, it remembers the real
+	// function and bumps a counter before forwarding to it
+	template<auto Slot, int Index>
+	struct Hook;
+
+	template<typename R, typename... Args, R (APIENTRYP *Slot)(Args...), int Index>
+	struct Hook<Slot, Index> {
+		static R (APIENTRYP original)(Args...);
+
+		static R APIENTRY Thunk(Args... args) {
+			++counts[Index];
+			return original(args...);
+		}
+
+		static void Install() {
+			// some entry points might not exist on this driver, leave those null
+			if (*Slot == nullptr) {
+				return;
+			}
+			original = *Slot;
+			*Slot = &Thunk;
+		}
+	};
+
+	template<typename R, typename... Args, R (APIENTRYP *Slot)(Args...), int Index>
+	R (APIENTRYP Hook<Slot, Index>::original)(Args...) = nullptr;
+}
+
+void GLStats::InstallCounters() {
+	if (installed) {
+		return;
+	}
+#define GLSTATS_INSTALL(fn) Hook<&glad_##fn, fn##_index>::Install();
+	GLSTATS_FUNCTIONS(GLSTATS_INSTALL)
+#undef GLSTATS_INSTALL
+	installed = true;
+	Reset();
+}
+
+bool GLStats::Installed() {
+	return installed;
+}
+
+void GLStats::Reset() {
+	for (int i = 0; i < FUNCTION_COUNT; i++) {
+		counts[i] = 0;
+	}
+}
+
+unsigned long long GLStats::Total() {
+	unsigned long long total = 0;
+	for (int i = 0; i < FUNCTION_COUNT; i++) {
+		total += counts[i];
+	}
+	return total;
+}
+
+std::vector<GLStats::Entry> GLStats::Snapshot() {
+	std::vector<Entry> entries;
+	for (int i = 0; i < FUNCTION_COUNT; i++) {
+		if (counts[i] > 0) {
+			entries.push_back({ names[i], counts[i] });
+		}
+	}
+	return entries;
+}
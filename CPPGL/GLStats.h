@@ -0,0 +1,22 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+
+// counts GL calls by swapping glad's function pointers for thin counting wrappers,
+// so the bench can report how many driver calls a frame actually makes
+namespace GLStats {
+	struct Entry {
+		const char *name;
+		unsigned long long count;
+	};
+
+	// call once after glad is loaded; does nothing if already installed
+	void InstallCounters();
+	bool Installed();
+	void Reset();
+	// total calls since the last Reset, across every counted function
+	unsigned long long Total();
+	// per-function counts, only the functions that were actually called
+	std::vector<Entry> Snapshot();
+}
@@ -0,0 +1,131 @@
+#include "MappedFile.h"
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : data(NULL), size(0)
+#ifdef _WIN32
+	, file(NULL), mapping(NULL)
+#endif
+{
+}
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const char *path) : MappedFile() {
+	HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (handle == INVALID_HANDLE_VALUE) {
+		std::cout << "couldn't open " << path << std::endl;
+		return;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0) {
+		// an empty file can't be mapped
+		std::cout << "couldn't map " << path << ", it's empty" << std::endl;
+		CloseHandle(handle);
+		return;
+	}
+	file = handle;
+	mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping != NULL) {
+		data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	}
+	if (data == NULL) {
+		std::cout << "couldn't map " << path << std::endl;
+		Close();
+		return;
+	}
+	size = (size_t)fileSize.QuadPart;
+}
+
+void MappedFile::Close() {
+	if (data != NULL) {
+		UnmapViewOfFile(data);
+	}
+	if (mapping != NULL) {
+		CloseHandle(mapping);
+	}
+	if (file != NULL) {
+		CloseHandle(file);
+	}
+	data = NULL;
+	size = 0;
+	file = NULL;
+	mapping = NULL;
+}
+
+#else
+
+MappedFile::MappedFile(const char *path) : MappedFile() {
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		std::cout << "couldn't open " << path << std::endl;
+		return;
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0) {
+		std::cout << "couldn't map " << path << ", it's empty" << std::endl;
+		close(fd);
+		return;
+	}
+	void *mapped = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping keeps its own reference to the file
+	close(fd);
+	if (mapped == MAP_FAILED) {
+		std::cout << "couldn't map " << path << std::endl;
+		return;
+	}
+	data = (const unsigned char*)mapped;
+	size = (size_t)info.st_size;
+	// it's about to be read front to back, start paging it in now
+	madvise(mapped, size, MADV_WILLNEED);
+}
+
+void MappedFile::Close() {
+	if (data != NULL) {
+		munmap((void*)data, size);
+	}
+	data = NULL;
+	size = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept : MappedFile() {
+	take(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+	if (this != &other) {
+		Close();
+		take(other);
+	}
+	return *this;
+}
+
+void MappedFile::take(MappedFile &other) {
+	data = other.data;
+	size = other.size;
+	other.data = NULL;
+	other.size = 0;
+#ifdef _WIN32
+	file = other.file;
+	mapping = other.mapping;
+	other.file = NULL;
+	other.mapping = NULL;
+#endif
+}
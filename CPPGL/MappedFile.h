@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+// a whole file mapped read-only into memory, so reading it is just pointer
+// access and the OS pages it in (and keeps it cached between runs). unmapped
+// when it goes out of scope, moves hand the mapping over
+class MappedFile {
+public:
+	MappedFile();
+	// Data() is NULL if the file couldn't be opened or mapped, the reason has been printed
+	explicit MappedFile(const char *path);
+	~MappedFile();
+	MappedFile(MappedFile &&other) noexcept;
+	MappedFile &operator=(MappedFile &&other) noexcept;
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	bool IsOpen() const { return data != NULL; }
+	const unsigned char *Data() const { return data; }
+	size_t Size() const { return size; }
+	void Close();
+
+private:
+	const unsigned char *data;
+	size_t size;
+#ifdef _WIN32
+	// the file and mapping HANDLEs, void* so windows.h stays out of the header
+	void *file;
+	void *mapping;
+#endif
+
+	void take(MappedFile &other);
+};
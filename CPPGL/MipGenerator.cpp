@@ -0,0 +1,436 @@
+#include "MipGenerator.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPPGL_MIP_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// msvc lets any function use any instruction set, it's up to Detect to only call what the cpu has
+#define CPPGL_TARGET_SSE2
+#define CPPGL_TARGET_AVX2
+#else
+#define CPPGL_TARGET_SSE2 __attribute__((target("sse2")))
+#define CPPGL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+	const int MAX_TAPS = 8;
+	// linear to srgb table resolution, fine enough that no dark value is off by more than a step
+	const int SRGB_STEPS = 8192;
+
+	// a 1d halving filter: output pixel x reads source pixels 2x + first onwards
+	struct Taps {
+		int first;
+		int count;
+		float weights[MAX_TAPS];
+	};
+
+	double besselI0(double x) {
+		double sum = 1.0, term = 1.0;
+		for (int k = 1; k < 32; k++) {
+			term *= (x / (2.0 * k)) * (x / (2.0 * k));
+			sum += term;
+		}
+		return sum;
+	}
+
+	Taps makeTaps(MipGenerator::Filter filter) {
+		Taps taps;
+		if (filter == MipGenerator::BOX) {
+			taps.first = 0;
+			taps.count = 2;
+			taps.weights[0] = taps.weights[1] = 0.5f;
+			return taps;
+		}
+		// sinc cut off at the new nyquist, under a kaiser window 4 source pixels each side
+		const double pi = 3.14159265358979323846;
+		const double beta = 4.0;
+		taps.first = -3;
+		taps.count = 8;
+		double total = 0.0;
+		double weights[MAX_TAPS];
+		for (int k = 0; k < taps.count; k++) {
+			// from the output pixel's centre, which sits between source pixels 2x and 2x + 1
+			double t = taps.first + k - 0.5;
+			double x = pi * t / 2.0;
+			double sinc = x == 0.0 ? 1.0 : std::sin(x) / x;
+			double window = t / 4.0;
+			double kaiser = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - window * window))) / besselI0(beta);
+			weights[k] = sinc * kaiser;
+			total += weights[k];
+		}
+		for (int k = 0; k < taps.count; k++) {
+			taps.weights[k] = (float)(weights[k] / total);
+		}
+		return taps;
+	}
+
+	struct Tables {
+		float srgbToLinear[256];
+		float byteToLinear[256];
+		unsigned char linearToSrgb[SRGB_STEPS + 1];
+	};
+
+	const Tables &tables() {
+		// built on first use, which is thread safe for a function local static
+		static const Tables built = []() {
+			Tables t;
+			for (int i = 0; i < 256; i++) {
+				double v = i / 255.0;
+				t.srgbToLinear[i] = (float)(v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4));
+				t.byteToLinear[i] = (float)v;
+			}
+			for (int i = 0; i <= SRGB_STEPS; i++) {
+				double v = (double)i / SRGB_STEPS;
+				double s = v <= 0.0031308 ? v * 12.92 : 1.055 * std::pow(v, 1.0 / 2.4) - 0.055;
+				t.linearToSrgb[i] = (unsigned char)std::lround(std::min(1.0, std::max(0.0, s)) * 255.0);
+			}
+			return t;
+		}();
+		return built;
+	}
+
+	// rows of linear, premultiplied float rgba: converted from the 8 bit base
+	// level as they're asked for, or read straight out of the level above
+	class Rows {
+	public:
+		Rows(const unsigned char *pixels, int width, int height, const MipGenerator::Options &options)
+			: pixels(pixels), floats(NULL), width(width), height(height), options(&options),
+			cache((size_t)MAX_TAPS * width * 4)
+		{
+			std::fill(cached, cached + MAX_TAPS, -1);
+		}
+
+		Rows(const float *floats, int width, int height, const MipGenerator::Options &options)
+			: pixels(NULL), floats(floats), width(width), height(height), options(&options)
+		{
+			std::fill(cached, cached + MAX_TAPS, -1);
+		}
+
+		// clamped to the image. a filter window is at most MAX_TAPS rows in a row,
+		// so every row it asks for gets its own slot in the cache
+		const float *Get(int y) {
+			y = std::min(std::max(y, 0), height - 1);
+			if (floats != NULL) {
+				return floats + (size_t)y * width * 4;
+			}
+			int slot = y % MAX_TAPS;
+			float *row = &cache[(size_t)slot * width * 4];
+			if (cached[slot] != y) {
+				convert(pixels + (size_t)y * width * 4, row);
+				cached[slot] = y;
+			}
+			return row;
+		}
+
+	private:
+		const unsigned char *pixels;
+		const float *floats;
+		int width;
+		int height;
+		const MipGenerator::Options *options;
+		std::vector<float> cache;
+		int cached[MAX_TAPS];
+
+		void convert(const unsigned char *in, float *out) {
+			const float *toLinear = options->srgb ? tables().srgbToLinear : tables().byteToLinear;
+			for (int x = 0; x < width; x++, in += 4, out += 4) {
+				float alpha = in[3] / 255.0f;
+				for (int c = 0; c < 3; c++) {
+					int value = in[c];
+					// the curve has to come off before multiplying by alpha in linear
+					if (options->premultiplied) {
+						value = in[3] > 0 ? std::min(255, (value * 255 + in[3] / 2) / in[3]) : 0;
+					}
+					out[c] = toLinear[value] * alpha;
+				}
+				out[3] = alpha;
+			}
+		}
+	};
+
+	typedef void (*VerticalPass)(const float *const *rows, const float *weights, int count, int floats, float *out);
+	typedef void (*HorizontalPass)(const float *row, int width, const Taps &taps, float *out, int outWidth);
+
+	// every path adds the taps up in the same order with no fused multiply-adds,
+	// so they round the same and give the same pixels
+
+	void verticalScalar(const float *const *rows, const float *weights, int count, int floats, float *out) {
+		for (int i = 0; i < floats; i++) {
+			float sum = 0.0f;
+			for (int k = 0; k < count; k++) {
+				sum += weights[k] * rows[k][i];
+			}
+			out[i] = sum;
+		}
+	}
+
+	// one output pixel with the source clamped at the edges, for the pixels the
+	// vector loops can't reach without reading off the row
+	void horizontalPixel(const float *row, int width, const Taps &taps, int x, float *out) {
+		for (int c = 0; c < 4; c++) {
+			float sum = 0.0f;
+			for (int k = 0; k < taps.count; k++) {
+				int source = std::min(std::max(2 * x + taps.first + k, 0), width - 1);
+				sum += taps.weights[k] * row[source * 4 + c];
+			}
+			out[x * 4 + c] = sum;
+		}
+	}
+
+	// the output pixels whose taps all land inside the row
+	void interior(int width, const Taps &taps, int outWidth, int &start, int &end) {
+		start = std::min(outWidth, (-taps.first + 1) / 2);
+		int span = width - taps.first - taps.count;
+		end = span < 0 ? start : std::max(start, std::min(outWidth, span / 2 + 1));
+	}
+
+	void horizontalScalar(const float *row, int width, const Taps &taps, float *out, int outWidth) {
+		for (int x = 0; x < outWidth; x++) {
+			horizontalPixel(row, width, taps, x, out);
+		}
+	}
+
+#ifdef CPPGL_MIP_X86
+	CPPGL_TARGET_SSE2 void verticalSse2(const float *const *rows, const float *weights, int count, int floats,
+		float *out)
+	{
+		int i = 0;
+		for (; i + 4 <= floats; i += 4) {
+			__m128 sum = _mm_setzero_ps();
+			for (int k = 0; k < count; k++) {
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(rows[k] + i)));
+			}
+			_mm_storeu_ps(out + i, sum);
+		}
+		for (; i < floats; i++) {
+			float sum = 0.0f;
+			for (int k = 0; k < count; k++) {
+				sum += weights[k] * rows[k][i];
+			}
+			out[i] = sum;
+		}
+	}
+
+	// a pixel is 4 floats, so one register holds one pixel
+	CPPGL_TARGET_SSE2 void horizontalSse2(const float *row, int width, const Taps &taps, float *out, int outWidth) {
+		int start, end;
+		interior(width, taps, outWidth, start, end);
+		for (int x = 0; x < start; x++) {
+			horizontalPixel(row, width, taps, x, out);
+		}
+		for (int x = start; x < end; x++) {
+			const float *source = row + (2 * x + taps.first) * 4;
+			__m128 sum = _mm_setzero_ps();
+			for (int k = 0; k < taps.count; k++) {
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(taps.weights[k]), _mm_loadu_ps(source + k * 4)));
+			}
+			_mm_storeu_ps(out + x * 4, sum);
+		}
+		for (int x = end; x < outWidth; x++) {
+			horizontalPixel(row, width, taps, x, out);
+		}
+	}
+
+	CPPGL_TARGET_AVX2 void verticalAvx2(const float *const *rows, const float *weights, int count, int floats,
+		float *out)
+	{
+		int i = 0;
+		for (; i + 8 <= floats; i += 8) {
+			__m256 sum = _mm256_setzero_ps();
+			for (int k = 0; k < count; k++) {
+				sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weights[k]), _mm256_loadu_ps(rows[k] + i)));
+			}
+			_mm256_storeu_ps(out + i, sum);
+		}
+		for (; i < floats; i++) {
+			float sum = 0.0f;
+			for (int k = 0; k < count; k++) {
+				sum += weights[k] * rows[k][i];
+			}
+			out[i] = sum;
+		}
+	}
+
+	// two output pixels per register: the low half reads from 2x, the high half
+	// from two source pixels further on
+	CPPGL_TARGET_AVX2 void horizontalAvx2(const float *row, int width, const Taps &taps, float *out, int outWidth) {
+		int start, end;
+		interior(width, taps, outWidth, start, end);
+		for (int x = 0; x < start; x++) {
+			horizontalPixel(row, width, taps, x, out);
+		}
+		int x = start;
+		for (; x + 2 <= end; x += 2) {
+			const float *source = row + (2 * x + taps.first) * 4;
+			__m256 sum = _mm256_setzero_ps();
+			for (int k = 0; k < taps.count; k++) {
+				__m256 pixels = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(source + k * 4)),
+					_mm_loadu_ps(source + (k + 2) * 4), 1);
+				sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(taps.weights[k]), pixels));
+			}
+			_mm256_storeu_ps(out + x * 4, sum);
+		}
+		for (; x < outWidth; x++) {
+			horizontalPixel(row, width, taps, x, out);
+		}
+	}
+
+	MipGenerator::Path detectCpu() {
+		bool sse2 = false, avx2 = false;
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		int leaves = info[0];
+		__cpuid(info, 1);
+		sse2 = (info[3] & (1 << 26)) != 0;
+		// the os has to save the wide registers too, or avx faults
+		bool avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+		if (avx && leaves >= 7) {
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+		}
+#else
+		__builtin_cpu_init();
+		sse2 = __builtin_cpu_supports("sse2");
+		avx2 = __builtin_cpu_supports("avx2");
+#endif
+		return avx2 ? MipGenerator::AVX2 : sse2 ? MipGenerator::SSE2 : MipGenerator::SCALAR;
+	}
+#endif
+
+	// the share of the level whose alpha passes the cutoff once scaled
+	float coverage(const std::vector<float> &level, float scale, float cutoff) {
+		size_t passing = 0;
+		for (size_t i = 3; i < level.size(); i += 4) {
+			passing += std::min(1.0f, level[i] * scale) >= cutoff ? 1 : 0;
+		}
+		return (float)passing / (level.size() / 4);
+	}
+
+	// the alpha scale that brings the level's coverage back to target, by bisection
+	float coverageScale(const std::vector<float> &level, float target, float cutoff) {
+		float low = 0.0f, high = 4.0f;
+		for (int iteration = 0; iteration < 16; iteration++) {
+			float middle = (low + high) / 2.0f;
+			if (coverage(level, middle, cutoff) < target) {
+				low = middle;
+			} else {
+				high = middle;
+			}
+		}
+		return high;
+	}
+
+	MipGenerator::Level toBytes(const std::vector<float> &level, int width, int height,
+		const MipGenerator::Options &options, float alphaScale)
+	{
+		const Tables &t = tables();
+		MipGenerator::Level out;
+		out.width = width;
+		out.height = height;
+		out.pixels.resize((size_t)width * height * 4);
+		unsigned char *bytes = out.pixels.data();
+		for (size_t i = 0; i < level.size(); i += 4) {
+			float alpha = level[i + 3];
+			int alphaByte = (int)std::lround(std::min(1.0f, std::max(0.0f, alpha * alphaScale)) * 255.0f);
+			for (int c = 0; c < 3; c++) {
+				// back to straight colour, the kaiser lobes can overshoot so clamp it
+				float color = alpha > 0.0f ? std::min(1.0f, std::max(0.0f, level[i + c] / alpha)) : 0.0f;
+				int value = options.srgb ? t.linearToSrgb[(int)(color * SRGB_STEPS + 0.5f)]
+					: (int)std::lround(color * 255.0f);
+				if (options.premultiplied) {
+					value = (value * alphaByte + 127) / 255;
+				}
+				bytes[i + c] = (unsigned char)value;
+			}
+			bytes[i + 3] = (unsigned char)alphaByte;
+		}
+		return out;
+	}
+}
+
+namespace MipGenerator {
+	Path Detect() {
+#ifdef CPPGL_MIP_X86
+		static const Path detected = detectCpu();
+		return detected;
+#else
+		return SCALAR;
+#endif
+	}
+
+	const char *PathName(Path path) {
+		static const char *names[] = { "auto", "scalar", "sse2", "avx2" };
+		return names[path];
+	}
+
+	std::vector<Level> Generate(const unsigned char *pixels, int width, int height, const Options &options) {
+		// asking for more than the cpu has gets the best it does have
+		Path path = options.path == AUTO ? Detect() : std::min(options.path, Detect());
+		VerticalPass vertical = verticalScalar;
+		HorizontalPass horizontal = horizontalScalar;
+#ifdef CPPGL_MIP_X86
+		if (path == SSE2) {
+			vertical = verticalSse2;
+			horizontal = horizontalSse2;
+		} else if (path == AVX2) {
+			vertical = verticalAvx2;
+			horizontal = horizontalAvx2;
+		}
+#endif
+
+		int levelCount = 0;
+		for (int size = std::max(width, height); size > 1; size >>= 1) {
+			levelCount++;
+		}
+		if (options.levels > 0) {
+			levelCount = std::min(levelCount, options.levels);
+		}
+
+		float targetCoverage = 0.0f;
+		if (options.alphaCutoff > 0.0f) {
+			size_t passing = 0;
+			for (size_t i = 3; i < (size_t)width * height * 4; i += 4) {
+				passing += pixels[i] >= options.alphaCutoff * 255.0f ? 1 : 0;
+			}
+			targetCoverage = (float)passing / ((size_t)width * height);
+		}
+
+		Taps taps = makeTaps(options.filter);
+		std::vector<Level> levels;
+		std::vector<float> above, level;
+		std::vector<float> filtered((size_t)width * 4);
+		Rows rows(pixels, width, height, options);
+		for (int i = 0; i < levelCount; i++) {
+			int levelWidth = std::max(1, width >> 1);
+			int levelHeight = std::max(1, height >> 1);
+			level.resize((size_t)levelWidth * levelHeight * 4);
+			// down the columns into one full width row, then halve that row
+			for (int y = 0; y < levelHeight; y++) {
+				const float *window[MAX_TAPS];
+				for (int k = 0; k < taps.count; k++) {
+					window[k] = rows.Get(2 * y + taps.first + k);
+				}
+				vertical(window, taps.weights, taps.count, width * 4, filtered.data());
+				horizontal(filtered.data(), width, taps, &level[(size_t)y * levelWidth * 4], levelWidth);
+			}
+
+			// the scale only goes into the bytes, the next level is filtered from the real alpha.
+			// nothing passing at the base leaves no coverage to keep, and bisecting towards
+			// zero would only fade the lower levels out entirely
+			float alphaScale = options.alphaCutoff > 0.0f && targetCoverage > 0.0f
+				? coverageScale(level, targetCoverage, options.alphaCutoff) : 1.0f;
+			levels.push_back(toBytes(level, levelWidth, levelHeight, options, alphaScale));
+
+			above.swap(level);
+			width = levelWidth;
+			height = levelHeight;
+			rows = Rows(above.data(), width, height, options);
+		}
+		return levels;
+	}
+}
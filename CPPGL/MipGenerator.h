@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+
+// builds mip chains on the cpu, so they can be made on a loader thread (or
+// offline) instead of with glGenerateMipmap on the GL thread. filtering is done
+// in linear light on premultiplied colour, the way glGenerateMipmap on an rgba8
+// texture doesn't: an srgb image gets darker and transparent pixels bleed their
+// colour into the smaller levels otherwise
+namespace MipGenerator {
+	enum Filter {
+		BOX, // 2x2 average
+		KAISER // 8 tap kaiser windowed sinc, sharper with a little ringing
+	};
+
+	// which filter loops to run, AUTO being the fastest the cpu has. the others
+	// are there to compare, they all give the same pixels
+	enum Path {
+		AUTO,
+		SCALAR,
+		SSE2,
+		AVX2
+	};
+
+	struct Options {
+		Filter filter = BOX;
+		// the pixels are srgb encoded, so decode them before filtering
+		bool srgb = true;
+		// rgb has already been multiplied by alpha, and the levels come out that way too
+		bool premultiplied = false;
+		// for cutout sprites drawn with an alpha test: each level's alpha is scaled
+		// so the same share of it passes this cutoff (0 to 1) as the base level.
+		// 0 leaves alpha alone
+		float alphaCutoff = 0.0f;
+		// how many levels below the base to make, 0 means down to 1x1
+		int levels = 0;
+		Path path = AUTO;
+	};
+
+	struct Level {
+		int width;
+		int height;
+		// tightly packed rgba8
+		std::vector<unsigned char> pixels;
+	};
+
+	// every level below the base, largest first. pixels is the tightly packed rgba8 base level
+	std::vector<Level> Generate(const unsigned char *pixels, int width, int height, const Options &options);
+	// what AUTO picks on this cpu
+	Path Detect();
+	const char *PathName(Path path);
+}
@@ -0,0 +1,24 @@
+#include "Names.h"
+#include <unordered_map>
+#include <deque>
+
+namespace {
+	// a deque so references handed out by Lookup stay valid as more names come in
+	std::deque<std::string> strings;
+	std::unordered_map<std::string, Names::Id> ids;
+}
+
+Names::Id Names::Intern(const std::string &name) {
+	auto it = ids.find(name);
+	if (it != ids.end()) {
+		return it->second;
+	}
+	Id id = (Id)strings.size();
+	strings.push_back(name);
+	ids.emplace(name, id);
+	return id;
+}
+
+const std::string &Names::Lookup(Id id) {
+	return strings.at(id);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+// string interning: every distinct name gets a small integer once, so later
+// lookups hash and compare an int instead of the whole string
+namespace Names {
+	typedef unsigned int Id;
+
+	Id Intern(const std::string &name);
+	// the string an id was interned from
+	const std::string &Lookup(Id id);
+}
@@ -0,0 +1,197 @@
+#include "ProgramCache.h"
+#include "GLExtensions.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace {
+	// bump VERSION whenever the header layout changes
+	const char MAGIC[4] = { 'C', 'P', 'G', 'B' };
+	const unsigned int VERSION = 1;
+
+	struct Header {
+		char magic[4];
+		unsigned int version;
+		unsigned long long key;
+		GLenum format;
+		unsigned int length;
+	};
+
+	std::string directory = "shader_cache";
+	bool enabledChecked = false;
+	bool enabled = false;
+	ProgramCache::Stats stats = {};
+
+	// FNV-1a, plenty for telling sources and drivers apart
+	unsigned long long hashBytes(unsigned long long hash, const void *data, size_t size) {
+		const unsigned char *bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	unsigned long long hashString(unsigned long long hash, const char *text) {
+		if (text == NULL) {
+			text = "";
+		}
+		// include the terminator so "ab"+"c" and "a"+"bc" hash differently
+		return hashBytes(hash, text, strlen(text) + 1);
+	}
+
+	std::filesystem::path entryPath(unsigned long long key) {
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx.bin", key);
+		return std::filesystem::path(directory) / name;
+	}
+}
+
+void ProgramCache::SetDirectory(const std::string &path) {
+	directory = path;
+}
+
+bool ProgramCache::Enabled() {
+	if (!enabledChecked) {
+		enabledChecked = true;
+		GLint formats = 0;
+		if (GLExtensions::ARB_get_program_binary) {
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+		}
+		enabled = formats > 0;
+	}
+	return enabled;
+}
+
+void ProgramCache::SetEnabled(bool value) {
+	enabledChecked = true;
+	enabled = value && GLExtensions::ARB_get_program_binary;
+}
+
+unsigned long long ProgramCache::Key(const std::string &vertexCode, const std::string &fragmentCode) {
+	unsigned long long hash = 14695981039346656037ull;
+	hash = hashBytes(hash, &VERSION, sizeof(VERSION));
+	hash = hashString(hash, vertexCode.c_str());
+	hash = hashString(hash, fragmentCode.c_str());
+	hash = hashString(hash, (const char*)glGetString(GL_VENDOR));
+	hash = hashString(hash, (const char*)glGetString(GL_RENDERER));
+	hash = hashString(hash, (const char*)glGetString(GL_VERSION));
+	return hash;
+}
+
+bool ProgramCache::Load(unsigned long long key, GLuint program) {
+	if (!Enabled()) {
+		return false;
+	}
+	std::filesystem::path path = entryPath(key);
+	std::ifstream in(path, std::ios::binary);
+	if (!in) {
+		return false;
+	}
+
+	Header header;
+	std::vector<char> binary;
+	bool valid = in.read((char*)&header, sizeof(header))
+		&& memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+		&& header.version == VERSION
+		&& header.key == key;
+	if (valid) {
+		binary.resize(header.length);
+		valid = (bool)in.read(binary.data(), binary.size());
+	}
+	in.close();
+
+	GLint linked = GL_FALSE;
+	if (valid) {
+		glProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+		glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	}
+	if (linked != GL_TRUE) {
+		// either a corrupt file or the driver changed in a way the strings didn't show
+		stats.rejected++;
+		std::error_code ignored;
+		std::filesystem::remove(path, ignored);
+		return false;
+	}
+	return true;
+}
+
+void ProgramCache::Store(unsigned long long key, GLuint program) {
+	if (!Enabled()) {
+		return;
+	}
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) {
+		return;
+	}
+
+	Header header;
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.key = key;
+	header.length = (unsigned int)length;
+	std::vector<char> binary(length);
+	GLsizei written = 0;
+	glGetProgramBinary(program, length, &written, &header.format, binary.data());
+	header.length = (unsigned int)written;
+
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	std::filesystem::path path = entryPath(key);
+	// unique per writer, then rename over the real name in one step
+	std::filesystem::path temp = path;
+	temp += ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+	{
+		std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			std::cout << "shader cache: can't write " << temp.string() << std::endl;
+			return;
+		}
+		out.write((const char*)&header, sizeof(header));
+		out.write(binary.data(), written);
+		if (!out) {
+			out.close();
+			std::filesystem::remove(temp, error);
+			return;
+		}
+	}
+	std::filesystem::rename(temp, path, error);
+	if (error) {
+		std::filesystem::remove(temp, error);
+		return;
+	}
+	stats.stored++;
+}
+
+void ProgramCache::RecordLoad(bool hit, double milliseconds) {
+	if (hit) {
+		stats.hits++;
+		stats.hitMs += milliseconds;
+	} else {
+		stats.misses++;
+		stats.missMs += milliseconds;
+	}
+}
+
+ProgramCache::Stats ProgramCache::GetStats() {
+	return stats;
+}
+
+void ProgramCache::PrintReport() {
+	unsigned int total = stats.hits + stats.misses;
+	if (total == 0) {
+		return;
+	}
+	printf("shader cache: %s, %u programs, %u hits (%.0f%%), %u misses, %u rejected, %u stored\n",
+		Enabled() ? directory.c_str() : "disabled", total, stats.hits, 100.0 * stats.hits / total,
+		stats.misses, stats.rejected, stats.stored);
+	printf("  cached programs  %.2f ms total, %.2f ms avg\n",
+		stats.hitMs, stats.hits ? stats.hitMs / stats.hits : 0.0);
+	printf("  compiled         %.2f ms total, %.2f ms avg\n",
+		stats.missMs, stats.misses ? stats.missMs / stats.misses : 0.0);
+}
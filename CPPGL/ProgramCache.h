@@ -0,0 +1,41 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+
+// on-disk cache of linked program binaries (glGetProgramBinary/glProgramBinary)
+// entries are keyed by a hash of the shader sources plus the driver's vendor,
+// renderer and version strings, so a source edit or a driver update just misses
+// and the stale file gets replaced on the next store
+namespace ProgramCache {
+	struct Stats {
+		unsigned int hits;
+		unsigned int misses;
+		// binaries the driver refused (or files that were cut short), recompiled instead
+		unsigned int rejected;
+		unsigned int stored;
+		double hitMs;
+		double missMs;
+	};
+
+	// defaults to "shader_cache" next to the working directory
+	void SetDirectory(const std::string &directory);
+	// off when the driver can't hand out program binaries at all
+	bool Enabled();
+	void SetEnabled(bool enabled);
+
+	// hash of everything that makes a binary valid: the sources and the driver
+	unsigned long long Key(const std::string &vertexCode, const std::string &fragmentCode);
+	// loads the cached binary for key into program, returns false if there isn't
+	// a usable one (and deletes it if the driver rejected it)
+	bool Load(unsigned long long key, GLuint program);
+	// writes a linked program's binary, via a temp file + rename so a crash
+	// mid-write never leaves a half written entry
+	void Store(unsigned long long key, GLuint program);
+
+	// Shader reports how long each program took to become usable, counting only
+	// its own compile and link calls, not the time it sat queued in a ShaderBatch
+	void RecordLoad(bool hit, double milliseconds);
+	Stats GetStats();
+	void PrintReport();
+}
@@ -0,0 +1,147 @@
+#include "RectPacker.h"
+#include <algorithm>
+#include <climits>
+
+static bool contains(const RectPacker::Rect &outer, const RectPacker::Rect &inner) {
+	return inner.x >= outer.x && inner.y >= outer.y
+		&& inner.x + inner.width <= outer.x + outer.width
+		&& inner.y + inner.height <= outer.y + outer.height;
+}
+
+static bool overlaps(const RectPacker::Rect &a, const RectPacker::Rect &b) {
+	return a.x < b.x + b.width && b.x < a.x + a.width
+		&& a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+RectPacker::RectPacker(int packerWidth, int packerHeight)
+	: width(packerWidth), height(packerHeight), usedArea(0)
+{
+	Clear();
+}
+
+void RectPacker::Clear() {
+	freeRects.assign(1, { 0, 0, width, height });
+	usedArea = 0;
+}
+
+bool RectPacker::Insert(int rectWidth, int rectHeight, Rect &placed) {
+	// best short side fit: the free rectangle that leaves the thinnest sliver
+	int bestShort = INT_MAX;
+	int bestLong = INT_MAX;
+	int best = -1;
+	for (size_t i = 0; i < freeRects.size(); i++) {
+		const Rect &free = freeRects[i];
+		if (free.width < rectWidth || free.height < rectHeight) {
+			continue;
+		}
+		int leftoverX = free.width - rectWidth;
+		int leftoverY = free.height - rectHeight;
+		int shortSide = std::min(leftoverX, leftoverY);
+		int longSide = std::max(leftoverX, leftoverY);
+		if (shortSide < bestShort || (shortSide == bestShort && longSide < bestLong)) {
+			bestShort = shortSide;
+			bestLong = longSide;
+			best = (int)i;
+		}
+	}
+	if (best < 0) {
+		return false;
+	}
+
+	placed = { freeRects[best].x, freeRects[best].y, rectWidth, rectHeight };
+	split(placed);
+	prune();
+	usedArea += (long long)rectWidth * rectHeight;
+	return true;
+}
+
+void RectPacker::split(const Rect &used) {
+	std::vector<Rect> pieces;
+	for (size_t i = 0; i < freeRects.size();) {
+		Rect free = freeRects[i];
+		if (!overlaps(free, used)) {
+			i++;
+			continue;
+		}
+		// up to four maximal rectangles are left around the used one
+		if (used.x > free.x) {
+			pieces.push_back({ free.x, free.y, used.x - free.x, free.height });
+		}
+		if (used.x + used.width < free.x + free.width) {
+			int right = used.x + used.width;
+			pieces.push_back({ right, free.y, free.x + free.width - right, free.height });
+		}
+		if (used.y > free.y) {
+			pieces.push_back({ free.x, free.y, free.width, used.y - free.y });
+		}
+		if (used.y + used.height < free.y + free.height) {
+			int bottom = used.y + used.height;
+			pieces.push_back({ free.x, bottom, free.width, free.y + free.height - bottom });
+		}
+		freeRects[i] = freeRects.back();
+		freeRects.pop_back();
+	}
+	freeRects.insert(freeRects.end(), pieces.begin(), pieces.end());
+}
+
+void RectPacker::prune() {
+	for (size_t i = 0; i < freeRects.size(); i++) {
+		for (size_t j = i + 1; j < freeRects.size();) {
+			if (contains(freeRects[i], freeRects[j])) {
+				freeRects.erase(freeRects.begin() + j);
+			} else if (contains(freeRects[j], freeRects[i])) {
+				freeRects.erase(freeRects.begin() + i);
+				j = i + 1;
+			} else {
+				j++;
+			}
+		}
+	}
+}
+
+void RectPacker::Free(const Rect &rect) {
+	usedArea -= (long long)rect.width * rect.height;
+	if (usedArea <= 0) {
+		// everything's been given back, start over instead of merging fragments
+		Clear();
+		return;
+	}
+
+	// grow the freed space into free neighbours that share a whole edge with it,
+	// so evicting two side by side rects leaves room for one twice as wide
+	Rect merged = rect;
+	bool grew = true;
+	while (grew) {
+		grew = false;
+		for (const Rect &free : freeRects) {
+			if (free.y == merged.y && free.height == merged.height) {
+				if (free.x + free.width == merged.x) {
+					merged.width += free.width;
+					merged.x = free.x;
+					grew = true;
+				} else if (merged.x + merged.width == free.x) {
+					merged.width += free.width;
+					grew = true;
+				}
+			} else if (free.x == merged.x && free.width == merged.width) {
+				if (free.y + free.height == merged.y) {
+					merged.height += free.height;
+					merged.y = free.y;
+					grew = true;
+				} else if (merged.y + merged.height == free.y) {
+					merged.height += free.height;
+					grew = true;
+				}
+			}
+		}
+	}
+	freeRects.push_back(rect);
+	if (merged.width != rect.width || merged.height != rect.height) {
+		freeRects.push_back(merged);
+	}
+	prune();
+}
+
+float RectPacker::Occupancy() const {
+	return (float)usedArea / ((float)width * height);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+// places rectangles in a fixed size area and gives them back later, using
+// maxrects: it keeps every maximal free rectangle (they overlap), puts each new
+// rectangle in the free one it fits most snugly, then cuts it out of all the
+// free rectangles it touches. freeing adds the space back and merges it with
+// neighbours where they line up, so a page can keep taking and evicting
+// rectangles at runtime. plain CPU bookkeeping, no GL
+class RectPacker {
+public:
+	struct Rect {
+		int x, y, width, height;
+	};
+
+	RectPacker(int width, int height);
+
+	// false if there's no room for it anywhere
+	bool Insert(int width, int height, Rect &placed);
+	// rect has to be one Insert handed out
+	void Free(const Rect &rect);
+	void Clear();
+
+	// fraction of the area that's handed out, 0..1
+	float Occupancy() const;
+	int Width() const { return width; }
+	int Height() const { return height; }
+
+private:
+	int width;
+	int height;
+	long long usedArea;
+	std::vector<Rect> freeRects;
+
+	// cuts used out of every free rectangle it overlaps
+	void split(const Rect &used);
+	// drops free rectangles that sit entirely inside another one
+	void prune();
+};
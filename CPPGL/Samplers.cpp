@@ -0,0 +1,60 @@
+#include "Samplers.h"
+#include "GLExtensions.h"
+#include "GLObjects.h"
+#include "GLState.h"
+#include <vector>
+
+namespace {
+	struct Entry {
+		Samplers::State state;
+		GLuint sampler;
+	};
+	// a handful of states at most, a flat list beats hashing
+	std::vector<Entry> samplers;
+
+	bool sameState(const Samplers::State &a, const Samplers::State &b) {
+		return a.minFilter == b.minFilter && a.magFilter == b.magFilter
+			&& a.wrapS == b.wrapS && a.wrapT == b.wrapT && a.anisotropy == b.anisotropy;
+	}
+}
+
+GLuint Samplers::Get(const State &state) {
+	for (const Entry &entry : samplers) {
+		if (sameState(entry.state, state)) {
+			return entry.sampler;
+		}
+	}
+
+	GLuint sampler = 0;
+	glGenSamplers(1, &sampler);
+	glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, state.minFilter);
+	glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, state.magFilter);
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, state.wrapS);
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, state.wrapT);
+	if (state.anisotropy > 1.0f && GLExtensions::texture_filter_anisotropic) {
+		GLfloat most = 1.0f;
+		glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &most);
+		glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY, state.anisotropy < most ? state.anisotropy : most);
+	}
+	GLObjects::Created(GLObjects::SAMPLER, sampler, 0);
+	samplers.push_back({ state, sampler });
+	return sampler;
+}
+
+GLuint Samplers::Get(GLint filter, GLint wrap) {
+	State state = { filter, filter, wrap, wrap, 1.0f };
+	return Get(state);
+}
+
+size_t Samplers::Count() {
+	return samplers.size();
+}
+
+void Samplers::Clear() {
+	for (const Entry &entry : samplers) {
+		glDeleteSamplers(1, &entry.sampler);
+		GLState::SamplerDeleted(entry.sampler);
+		GLObjects::Deleted(GLObjects::SAMPLER, entry.sampler);
+	}
+	samplers.clear();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+
+// shared sampler objects, one per distinct filtering/wrap state. a texture
+// bound alongside a sampler takes its filtering from the sampler instead of its
+// own glTexParameteri settings, so textures that sample the same way share one
+// sampler and never need their parameters touched
+namespace Samplers {
+	struct State {
+		GLint minFilter;
+		GLint magFilter;
+		GLint wrapS;
+		GLint wrapT;
+		// 1 for none, only applied when the driver has anisotropic filtering
+		GLfloat anisotropy;
+	};
+
+	// the sampler for state, made the first time anything asks for it
+	GLuint Get(const State &state);
+	// same filter both ways and the same wrap on both axes
+	GLuint Get(GLint filter, GLint wrap);
+	// how many distinct samplers exist, however many times they were asked for
+	size_t Count();
+
+	// deletes every sampler, do this before the context goes away
+	void Clear();
+}
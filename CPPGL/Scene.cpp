@@ -0,0 +1,131 @@
+#include "Scene.h"
+#include "GLState.h"
+#include "Samplers.h"
+#include "VertexFormat.h"
+#include <chrono>
+
+// flat orange, only needs the position attribute and no uniforms
+static const char *fallbackVertexSource =
+	"#version 330 core\n"
+	"layout (location = 0) in vec3 aPos;\n"
+	"void main() {\n"
+	"    gl_Position = vec4(aPos.x, aPos.y, aPos.z, 1.0);\n"
+	"}\0"
+;
+
+static const char *fallbackFragmentSource = 
+	"#version 330 core\n"
+	"out vec4 FragColor;\n"
+	"void main() {\n"
+		"FragColor = vec4(0.8f, 0.3f, 0.02f, 1.0f);\n"
+	"}\n\0"
+;
+
+// set up vertices and etc
+// have to be between -1 and 1 for clip space (or is it device space here?)
+// or... they're right up against the frustum i guess, so it might just be normalized
+// Vertices coordinates
+static GLfloat vertices[] =
+{ //     COORDINATES     /        COLORS      /   TexCoord  //
+	-0.5f, -0.5f, 0.0f,     1.0f, 0.0f, 0.0f,	0.0f, 0.0f, // Lower left corner
+	-0.5f,  0.5f, 0.0f,     0.0f, 1.0f, 0.0f,	0.0f, 1.0f, // Upper left corner
+	 0.5f,  0.5f, 0.0f,     0.0f, 0.0f, 1.0f,	1.0f, 1.0f, // Upper right corner
+	 0.5f, -0.5f, 0.0f,     1.0f, 1.0f, 1.0f,	1.0f, 0.0f  // Lower right corner
+};
+
+static_assert(sizeof(vertices) == 4 * QuadVertex::stride, "the quad's vertices should be QuadVertex");
+
+// Indices for vertices order
+static GLuint indices[] =
+{
+	0, 2, 1, // Upper triangle
+	0, 3, 2 // Lower triangle
+};
+
+// the element buffer gets recorded into whichever VAO is bound when it's created,
+// so vao1 has to be bound before ebo1 is constructed
+static GLuint *bindBeforeElements(VAO &vao, GLuint *elements) {
+	vao.Bind();
+	return elements;
+}
+
+// all openGL things can only be accessed by reference
+Scene::Scene()
+	: fallbackProgram(Shader::FromSource(fallbackVertexSource, fallbackFragmentSource)),
+	shaderProgram("default.vert", "default.frag", shaderBatch),
+	// list of vertices
+	vbo1(vertices, sizeof(vertices)),
+	// list of elements, bind it to vertices
+	ebo1(bindBeforeElements(vao1, indices), sizeof(indices)),
+	// decoded on the loader's threads, uploaded a bit at a time from Draw
+	texture("pumpkin panic 2 1x.png", textureLoader),
+	sampler(Samplers::Get(GL_NEAREST, GL_CLAMP_TO_EDGE)),
+	frame(),
+	frameUniforms(NULL, sizeof(UniformBlocks::FrameBlock)),
+	shaderReady(false)
+{
+	GLint viewport[4] = {};
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	frame.viewProjection = UniformBlocks::Identity();
+	frame.viewport = { (GLfloat)viewport[2], (GLfloat)viewport[3] };
+	frame.scale = 0.5f;
+
+	// get the driver compiling while the buffers load
+	shaderBatch.Submit();
+	shaderReloader.Watch(shaderProgram, "default.vert", "default.frag");
+
+	// link position, then color, then texcoords
+	// the structure is [ x y z r g b u v | x y z r g b u v], QuadVertex works out
+	// the stride and offsets from that at compile time
+	QuadVertex::Link(vao1, vbo1);
+	// unbind the rest to keep from modifyinig them and not having it be picked up?
+	// or would modifying them just be slow
+	vao1.Unbind();
+	vbo1.Unbind();
+	ebo1.Unbind();
+}
+
+void Scene::onShaderReady() {
+	shaderReady = true;
+	// the attributes were linked by location before the program existed, so check
+	// now that they're where it actually reads them
+	vao1.Validate(shaderProgram);
+	// the sampler reads from texture unit 0
+	shaderProgram.Set("tex0", 0);
+}
+
+void Scene::Draw() {
+	// front color: displayed on screen
+	// back buffer: written to in bg
+	glClearColor(0.07f, 0.13f, 0.17f, 1.0f);
+	// clean back buffer and assign new color to it
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	shaderReloader.Update();
+	if (!shaderReady && shaderBatch.Poll() && shaderProgram.Ready()) {
+		onShaderReady();
+	}
+	textureLoader.Update();
+
+	// one upload and one bind for the whole frame, every program that declares
+	// the Frame block reads it from there without any glUniform calls
+	static const auto start = std::chrono::steady_clock::now();
+	frame.time = std::chrono::duration<GLfloat>(std::chrono::steady_clock::now() - start).count();
+	frameUniforms.Update(0, &frame, sizeof(frame));
+	frameUniforms.BindBase(UniformBlocks::FRAME);
+
+	// here's the actual shape render code from the indices
+	// say which shader program we want to use
+	if (shaderReady && texture.Ready()) {
+		shaderProgram.Activate();
+		// then also have to bind it to texture unit 0 in the current frame
+		texture.Bind(0);
+		GLState::BindSampler(0, sampler);
+	} else {
+		fallbackProgram.Activate();
+	}
+	// bind the vertex array to the current rendering cycle
+	vao1.Bind();
+	// primitive type, # of indices, data type of indices, start index (offset)
+	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "shaderClass.h"
+#include "ShaderBatch.h"
+#include "ShaderReloader.h"
+#include "VAO.h"
+#include "VBO.h"
+#include "EBO.h"
+#include "Texture.h"
+#include "UBO.h"
+#include "UniformBlocks.h"
+#include "TextureLoader.h"
+
+// everything the main render loop draws, so the window and the headless bench
+// can both run the same frame. it owns its GL objects, so it has to be
+// destroyed while the context is still current
+class Scene {
+public:
+	// the real program compiles and the texture loads in the background, and
+	// until they're both ready the quad gets drawn with a flat color fallback
+	ShaderBatch shaderBatch;
+	// saving default.vert or default.frag swaps the new program in without a restart
+	ShaderReloader shaderReloader;
+	TextureLoader textureLoader;
+	Shader fallbackProgram;
+	Shader shaderProgram;
+	VAO vao1;
+	VBO vbo1;
+	EBO ebo1;
+	Texture texture;
+	// shared with anything else that samples nearest and clamped
+	GLuint sampler;
+	// the Frame block, uploaded once a frame and bound for every program at once
+	UniformBlocks::FrameBlock frame;
+	UBO frameUniforms;
+	bool shaderReady;
+
+	// expects default.vert, default.frag, uniform_blocks.glsl and the pumpkin png
+	// in the working directory, and the viewport to be set already
+	Scene();
+
+	// draws one frame into whatever framebuffer is bound
+	void Draw();
+
+private:
+	// uniforms can only be looked up once the program has linked
+	void onShaderReady();
+};
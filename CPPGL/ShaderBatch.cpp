@@ -0,0 +1,55 @@
+#include "ShaderBatch.h"
+#include "shaderClass.h"
+#include "GLExtensions.h"
+#include <algorithm>
+
+void ShaderBatch::Add(Shader *shader) {
+	queued.push_back(shader);
+}
+
+void ShaderBatch::Remove(Shader *shader) {
+	queued.erase(std::remove(queued.begin(), queued.end(), shader), queued.end());
+	inFlight.erase(std::remove(inFlight.begin(), inFlight.end(), shader), inFlight.end());
+}
+
+void ShaderBatch::Replace(Shader *from, Shader *to) {
+	std::replace(queued.begin(), queued.end(), from, to);
+	std::replace(inFlight.begin(), inFlight.end(), from, to);
+}
+
+void ShaderBatch::Submit() {
+	// all the compiles go out before any link, a link waits on its stages
+	for (Shader *shader : queued) {
+		shader->compile();
+	}
+	for (Shader *shader : queued) {
+		shader->link();
+	}
+	inFlight.insert(inFlight.end(), queued.begin(), queued.end());
+	queued.clear();
+}
+
+bool ShaderBatch::Poll() {
+	if (GLExtensions::parallel_shader_compile) {
+		// finish everything the driver says is done, without blocking on the rest
+		auto done = std::remove_if(inFlight.begin(), inFlight.end(), [](Shader *shader) {
+			return shader->Poll();
+		});
+		inFlight.erase(done, inFlight.end());
+	} else if (!inFlight.empty()) {
+		// no way to ask without stalling, so only stall on one per call
+		inFlight.front()->finish();
+		inFlight.erase(inFlight.begin());
+	}
+	return Pending() == 0;
+}
+
+void ShaderBatch::Wait() {
+	if (!queued.empty()) {
+		Submit();
+	}
+	for (Shader *shader : inFlight) {
+		shader->finish();
+	}
+	inFlight.clear();
+}
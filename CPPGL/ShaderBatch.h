@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+class Shader;
+
+// compiles a group of shaders together: every stage of every program gets
+// glCompileShader first, then every program gets glLinkProgram, and only then
+// do we look at results. with KHR_parallel_shader_compile the driver works on
+// them in the background and Poll never blocks; without it the status queries
+// are just put off until Poll, which finishes one program per call
+class ShaderBatch {
+public:
+	// Shader's batch constructor calls this, programs wait here until Submit
+	void Add(Shader *shader);
+	void Remove(Shader *shader);
+	// a pending Shader was moved, keep track of it at its new address
+	void Replace(Shader *from, Shader *to);
+
+	// kick off compiles and links for everything added so far
+	void Submit();
+	// finishes programs that are done, returns true once nothing is pending
+	bool Poll();
+	// blocks until every submitted program is finished
+	void Wait();
+
+	size_t Pending() const { return queued.size() + inFlight.size(); }
+
+private:
+	std::vector<Shader*> queued;
+	std::vector<Shader*> inFlight;
+};
@@ -0,0 +1,170 @@
+#include "ShaderPreprocessor.h"
+#include "shaderClass.h"
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+	struct State {
+		std::vector<std::string> files;
+		// the include chain down to the file being expanded, to catch cycles
+		std::vector<std::string> stack;
+		std::vector<std::string> once;
+		const std::vector<std::string> *defines;
+		// where the sources come from, files on disk when this is NULL
+		const AssetArchive *assets;
+	};
+
+	bool contains(const std::vector<std::string> &list, const std::string &value) {
+		return std::find(list.begin(), list.end(), value) != list.end();
+	}
+
+	// the directive's name if the line is a preprocessor directive, with rest
+	// pointing past it
+	std::string directive(const std::string &line, size_t &rest) {
+		size_t start = line.find_first_not_of(" \t");
+		if (start == std::string::npos || line[start] != '#') {
+			return "";
+		}
+		size_t name = line.find_first_not_of(" \t", start + 1);
+		if (name == std::string::npos) {
+			return "";
+		}
+		rest = line.find_first_of(" \t\r", name);
+		if (rest == std::string::npos) {
+			rest = line.size();
+		}
+		return line.substr(name, rest - name);
+	}
+
+	std::string defineLines(const std::vector<std::string> &defines) {
+		std::string lines;
+		for (const std::string &define : defines) {
+			std::string text = define;
+			std::replace(text.begin(), text.end(), '=', ' ');
+			lines += "#define " + text + "\n";
+		}
+		return lines;
+	}
+
+	void includeError(const State &state, const std::string &message) {
+		std::cout << "shader preprocessor: " << message;
+		for (auto file = state.stack.rbegin(); file != state.stack.rend(); ++file) {
+			std::cout << "\n  included from " << *file;
+		}
+		std::cout << std::endl;
+	}
+
+	void expand(const std::string &path, State &state, std::string &out) {
+		std::string source;
+		try {
+			source = state.assets != NULL ? get_asset_contents(*state.assets, path.c_str())
+				: get_file_contents(path.c_str());
+		} catch (int error) {
+			includeError(state, "couldn't read " + path);
+			throw(error);
+		}
+		size_t index = std::find(state.files.begin(), state.files.end(), path) - state.files.begin();
+		if (index == state.files.size()) {
+			state.files.push_back(path);
+		}
+		state.stack.push_back(path);
+		bool top = state.stack.size() == 1;
+		bool versioned = false;
+
+		size_t lineNumber = 0;
+		for (size_t start = 0; start < source.size(); ) {
+			size_t end = source.find('\n', start);
+			bool lastLine = end == std::string::npos;
+			std::string line = source.substr(start, lastLine ? std::string::npos : end - start);
+			start = lastLine ? source.size() : end + 1;
+			lineNumber++;
+
+			size_t rest = 0;
+			std::string name = directive(line, rest);
+			if (name == "include") {
+				size_t open = line.find_first_of("\"<", rest);
+				size_t close = open == std::string::npos ? std::string::npos
+					: line.find(line[open] == '"' ? '"' : '>', open + 1);
+				if (close == std::string::npos) {
+					includeError(state, path + ":" + std::to_string(lineNumber) + ": #include needs a \"file\"");
+					throw(EINVAL);
+				}
+				std::filesystem::path included = std::filesystem::path(path).parent_path()
+					/ line.substr(open + 1, close - open - 1);
+				std::string includedPath = included.lexically_normal().generic_string();
+				if (contains(state.stack, includedPath)) {
+					includeError(state, includedPath + " includes itself");
+					throw(ELOOP);
+				}
+				if (!contains(state.once, includedPath)) {
+					size_t includedIndex = std::find(state.files.begin(), state.files.end(), includedPath)
+						- state.files.begin();
+					out += "#line 1 " + std::to_string(includedIndex) + "\n";
+					expand(includedPath, state, out);
+					out += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(index) + "\n";
+				} else {
+					out += "\n";
+				}
+				continue;
+			}
+			if (name == "pragma" && line.find("once", rest) != std::string::npos) {
+				state.once.push_back(path);
+				out += "\n";
+				continue;
+			}
+
+			out += line;
+			if (!lastLine) {
+				out += "\n";
+			}
+			if (top && name == "version" && !state.defines->empty()) {
+				// defines have to come after #version, which has to come first
+				versioned = true;
+				if (lastLine) {
+					out += "\n";
+				}
+				out += defineLines(*state.defines);
+				out += "#line " + std::to_string(lineNumber + 1) + " 0\n";
+			}
+		}
+		if (top && !versioned && !state.defines->empty()) {
+			// no #version, so the defines just go first
+			out = defineLines(*state.defines) + "#line 1 0\n" + out;
+		}
+		if (!out.empty() && out.back() != '\n' && !top) {
+			// the #line after an include needs a line of its own
+			out += "\n";
+		}
+		state.stack.pop_back();
+	}
+
+	std::string process(const AssetArchive *assets, const std::string &file, const std::vector<std::string> &defines,
+		std::vector<std::string> *files)
+	{
+		State state;
+		state.defines = &defines;
+		state.assets = assets;
+		std::string out;
+		expand(std::filesystem::path(file).lexically_normal().generic_string(), state, out);
+		if (files != NULL) {
+			files->swap(state.files);
+		}
+		return out;
+	}
+}
+
+namespace ShaderPreprocessor {
+	std::string Process(const std::string &file, const std::vector<std::string> &defines,
+		std::vector<std::string> *files)
+	{
+		return process(NULL, file, defines, files);
+	}
+
+	std::string Process(const AssetArchive &assets, const std::string &name, const std::vector<std::string> &defines,
+		std::vector<std::string> *files)
+	{
+		return process(&assets, name, defines, files);
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+class AssetArchive;
+
+// what runs on shader source before the driver sees it: #include "file" pulls
+// in another file (relative to the one including it, once per file if it says
+// #pragma once), and a set of defines goes in right after #version, so one
+// source can be built with different features switched on. #line directives
+// keep compile errors pointing at the right line, with the source string
+// number being the file's index in the list Process hands back
+namespace ShaderPreprocessor {
+	// defines are "NAME" or "NAME=VALUE". throws errno like get_file_contents if
+	// a file can't be read, with the include chain printed. files gets every
+	// file that went into the result, the one asked for first
+	std::string Process(const std::string &file, const std::vector<std::string> &defines = {},
+		std::vector<std::string> *files = NULL);
+	// the same for a source in an archive, with includes looked up as other
+	// entries of it (relative to the including one, like files)
+	std::string Process(const AssetArchive &assets, const std::string &name,
+		const std::vector<std::string> &defines = {}, std::vector<std::string> *files = NULL);
+}
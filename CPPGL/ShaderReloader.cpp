@@ -0,0 +1,207 @@
+#include "ShaderReloader.h"
+#include "ShaderPreprocessor.h"
+#include "shaderClass.h"
+#include "Timing.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+static std::string normalize(const std::string &file) {
+	std::error_code error;
+	return std::filesystem::absolute(file, error).lexically_normal().string();
+}
+
+ShaderReloader::ShaderReloader() : stats(), notify(-1), lastPoll(std::chrono::steady_clock::now()) {
+#ifdef __linux__
+	notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (notify < 0) {
+		std::cout << "couldn't start inotify, checking shader files for changes instead" << std::endl;
+	}
+#endif
+}
+
+ShaderReloader::~ShaderReloader() {
+	for (Entry &entry : entries) {
+		entry.shader->reloader = NULL;
+	}
+	// the recompiles go before the batch they're on
+	entries.clear();
+#ifdef __linux__
+	if (notify >= 0) {
+		close(notify);
+	}
+#endif
+}
+
+void ShaderReloader::Watch(Shader &shader, const std::string &vertexFile, const std::string &fragmentFile,
+	const std::vector<std::string> &defines)
+{
+	if (shader.reloader != NULL) {
+		shader.reloader->Forget(&shader);
+	}
+	Entry entry;
+	entry.shader = &shader;
+	entry.vertexFile = vertexFile;
+	entry.fragmentFile = fragmentFile;
+	entry.defines = defines;
+	entry.dirty = false;
+	std::string vertex, fragment;
+	try {
+		preprocess(entry, vertex, fragment);
+	} catch (int) {
+		// the includes get picked up on the first reload that works
+		entry.files = { normalize(vertexFile), normalize(fragmentFile) };
+		watchFile(entry.files[0]);
+		watchFile(entry.files[1]);
+	}
+	entries.push_back(std::move(entry));
+	shader.reloader = this;
+}
+
+void ShaderReloader::preprocess(Entry &entry, std::string &vertex, std::string &fragment) {
+	std::vector<std::string> vertexFiles, fragmentFiles;
+	vertex = ShaderPreprocessor::Process(entry.vertexFile, entry.defines, &vertexFiles);
+	fragment = ShaderPreprocessor::Process(entry.fragmentFile, entry.defines, &fragmentFiles);
+	vertexFiles.insert(vertexFiles.end(), fragmentFiles.begin(), fragmentFiles.end());
+	for (const std::string &file : vertexFiles) {
+		std::string path = normalize(file);
+		if (std::find(entry.files.begin(), entry.files.end(), path) == entry.files.end()) {
+			entry.files.push_back(path);
+			watchFile(path);
+		}
+	}
+}
+
+void ShaderReloader::Forget(Shader *shader) {
+	for (size_t i = 0; i < entries.size(); i++) {
+		if (entries[i].shader == shader) {
+			entries.erase(entries.begin() + i);
+			return;
+		}
+	}
+}
+
+void ShaderReloader::Replace(Shader *from, Shader *to) {
+	for (Entry &entry : entries) {
+		if (entry.shader == from) {
+			entry.shader = to;
+		}
+	}
+}
+
+void ShaderReloader::Changed(const std::string &file) {
+	std::string path = normalize(file);
+	for (Entry &entry : entries) {
+		if (!entry.dirty && std::find(entry.files.begin(), entry.files.end(), path) != entry.files.end()) {
+			entry.dirty = true;
+			entry.changedAt = std::chrono::steady_clock::now();
+		}
+	}
+}
+
+void ShaderReloader::watchFile(const std::string &file) {
+#ifdef __linux__
+	if (notify >= 0) {
+		// the directory, not the file: editors save by writing a new file and
+		// renaming it over the old one, which a watch on the file itself loses
+		std::string directory = std::filesystem::path(file).parent_path().string();
+		int watch = inotify_add_watch(notify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+		if (watch >= 0) {
+			directories[watch] = directory;
+			return;
+		}
+		std::cout << "couldn't watch " << directory << " for shader changes" << std::endl;
+	}
+#endif
+	std::error_code error;
+	modified[file] = std::filesystem::last_write_time(file, error).time_since_epoch().count();
+}
+
+void ShaderReloader::collectChanges() {
+#ifdef __linux__
+	if (notify >= 0) {
+		alignas(inotify_event) char buffer[4096];
+		for (;;) {
+			ssize_t length = read(notify, buffer, sizeof(buffer));
+			if (length <= 0) {
+				break;
+			}
+			for (char *next = buffer; next < buffer + length; ) {
+				const inotify_event *event = (const inotify_event*)next;
+				auto directory = directories.find(event->wd);
+				if (event->len > 0 && directory != directories.end()) {
+					Changed(directory->second + "/" + event->name);
+				}
+				next += sizeof(inotify_event) + event->len;
+			}
+		}
+	}
+#endif
+	if (modified.empty() || millisecondsSince(lastPoll) < 250.0) {
+		return;
+	}
+	lastPoll = std::chrono::steady_clock::now();
+	for (auto &file : modified) {
+		std::error_code error;
+		long long time = std::filesystem::last_write_time(file.first, error).time_since_epoch().count();
+		// a file halfway through being replaced can be missing for a moment
+		if (!error && time != file.second) {
+			file.second = time;
+			Changed(file.first);
+		}
+	}
+}
+
+void ShaderReloader::startReload(Entry &entry) {
+	entry.dirty = false;
+	// an older recompile still going is out of date now, it takes itself off the batch
+	entry.next.reset();
+	std::string vertex, fragment;
+	try {
+		preprocess(entry, vertex, fragment);
+	} catch (int) {
+		// it'll come round again when the file is back
+		std::cout << "couldn't read " << entry.vertexFile << " or " << entry.fragmentFile
+			<< " to reload them" << std::endl;
+		return;
+	}
+	entry.next.reset(new Shader(Shader::FromSource(vertex.c_str(), fragment.c_str(), batch)));
+	batch.Submit();
+}
+
+void ShaderReloader::Update() {
+	collectChanges();
+	for (Entry &entry : entries) {
+		// one still compiling on its first batch can't be swapped out from under it
+		if (entry.dirty && entry.shader->status != Shader::PENDING) {
+			startReload(entry);
+		}
+	}
+	if (batch.Pending() > 0) {
+		batch.Poll();
+	}
+	for (Entry &entry : entries) {
+		if (entry.next == nullptr || entry.next->status == Shader::PENDING) {
+			continue;
+		}
+		std::string name = std::filesystem::path(entry.vertexFile).filename().string() + " + "
+			+ std::filesystem::path(entry.fragmentFile).filename().string();
+		if (entry.next->status == Shader::READY) {
+			entry.shader->swapProgram(*entry.next);
+			stats.reloads++;
+			stats.lastReloadMs = millisecondsSince(entry.changedAt);
+			std::cout << "reloaded shader " << name << " in " << stats.lastReloadMs << " ms" << std::endl;
+		} else {
+			// the compile log has been printed already
+			stats.failures++;
+			std::cout << "kept the old " << name << ", the new one didn't build" << std::endl;
+		}
+		// with the old program in it now
+		entry.next.reset();
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ShaderBatch.h"
+
+class Shader;
+
+// recompiles shaders when their source files change, so they can be edited with
+// the app running. on linux inotify says which files changed, elsewhere their
+// modification times get checked a few times a second. a changed program is
+// compiled and linked in the background on its own batch, and swapped into the
+// Shader in place only once it has linked, with every uniform value it had set
+// again, so UniformHandles stay valid and a typo just leaves the old program
+// drawing (with the compile log printed). everything happens in Update, on the
+// GL thread
+class ShaderReloader {
+public:
+	struct Stats {
+		unsigned int reloads;
+		// didn't compile or link, the old program was kept
+		unsigned int failures;
+		// from the file changing to the new program being swapped in
+		double lastReloadMs;
+	};
+
+	ShaderReloader();
+	// watched shaders keep whatever program they have
+	~ShaderReloader();
+	ShaderReloader(const ShaderReloader &) = delete;
+	ShaderReloader &operator=(const ShaderReloader &) = delete;
+
+	// reload shader from these files whenever either one, or anything they
+	// #include, changes. defines are the ones it was preprocessed with
+	void Watch(Shader &shader, const std::string &vertexFile, const std::string &fragmentFile,
+		const std::vector<std::string> &defines = {});
+	// Shader's destructor and move call these
+	void Forget(Shader *shader);
+	void Replace(Shader *from, Shader *to);
+	// reload everything using file as if it had changed on disk
+	void Changed(const std::string &file);
+
+	// picks up file changes, starts their recompiles, and swaps in the programs
+	// that have linked. once per frame, before drawing
+	void Update();
+
+	// recompiles still going
+	size_t Pending() const { return batch.Pending(); }
+	Stats GetStats() const { return stats; }
+
+private:
+	struct Entry {
+		Shader *shader;
+		std::string vertexFile;
+		std::string fragmentFile;
+		std::vector<std::string> defines;
+		// both stages and their includes, normalized so they compare equal to the
+		// paths the watcher reports
+		std::vector<std::string> files;
+		bool dirty;
+		std::chrono::steady_clock::time_point changedAt;
+		// the recompile in flight, swapped in once it's ready
+		std::unique_ptr<Shader> next;
+	};
+
+	std::vector<Entry> entries;
+	ShaderBatch batch;
+	Stats stats;
+	// inotify's descriptor and the directory each of its watches is on, -1 when
+	// it's not available and modification times get polled instead
+	int notify;
+	std::unordered_map<int, std::string> directories;
+	std::unordered_map<std::string, long long> modified;
+	std::chrono::steady_clock::time_point lastPoll;
+
+	void watchFile(const std::string &file);
+	// preprocesses both stages, picking up (and watching) any new includes.
+	// throws errno like get_file_contents
+	void preprocess(Entry &entry, std::string &vertex, std::string &fragment);
+	// marks everything using one of the files that changed since the last call
+	void collectChanges();
+	void startReload(Entry &entry);
+};
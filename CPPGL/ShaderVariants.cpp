@@ -0,0 +1,78 @@
+#include "ShaderVariants.h"
+#include "ShaderBatch.h"
+#include "ShaderPreprocessor.h"
+#include "ShaderReloader.h"
+#include "shaderClass.h"
+#include "Timing.h"
+#include <chrono>
+#include <iostream>
+
+ShaderVariants::ShaderVariants(const std::string &vertex, const std::string &fragment,
+	const std::vector<std::string> &featureNames, ShaderBatch *shaderBatch, ShaderReloader *shaderReloader)
+	: vertexFile(vertex), fragmentFile(fragment), features(featureNames), batch(shaderBatch),
+	reloader(shaderReloader), stats()
+{
+	if (features.size() > 32) {
+		std::cout << vertexFile << " + " << fragmentFile << " has " << features.size()
+			<< " features, only the first 32 can be used" << std::endl;
+		features.resize(32);
+	}
+}
+
+// out of line so the header doesn't need Shader's definition
+ShaderVariants::~ShaderVariants() {
+}
+
+uint32_t ShaderVariants::Bit(const std::string &feature) const {
+	for (size_t i = 0; i < features.size(); i++) {
+		if (features[i] == feature) {
+			return 1u << i;
+		}
+	}
+	std::cout << vertexFile << " + " << fragmentFile << " has no feature " << feature << std::endl;
+	return 0;
+}
+
+std::vector<std::string> ShaderVariants::Defines(uint32_t mask) const {
+	std::vector<std::string> defines;
+	for (size_t i = 0; i < features.size(); i++) {
+		if (mask & (1u << i)) {
+			defines.push_back(features[i]);
+		}
+	}
+	return defines;
+}
+
+Shader &ShaderVariants::Get(uint32_t mask) {
+	stats.requests++;
+	std::unique_ptr<Shader> &variant = variants[mask];
+	if (variant != nullptr) {
+		return *variant;
+	}
+
+	std::vector<std::string> defines = Defines(mask);
+	std::string vertex, fragment;
+	auto start = std::chrono::steady_clock::now();
+	try {
+		vertex = ShaderPreprocessor::Process(vertexFile, defines);
+		fragment = ShaderPreprocessor::Process(fragmentFile, defines);
+	} catch (int) {
+		// what went wrong has been printed, hand back a FAILED shader so it's not retried every frame
+		variant.reset(new Shader());
+		variant->status = Shader::FAILED;
+		return *variant;
+	}
+	stats.preprocessMs += millisecondsSince(start);
+	stats.compiled++;
+
+	if (batch != NULL) {
+		variant.reset(new Shader(Shader::FromSource(vertex.c_str(), fragment.c_str(), *batch)));
+		batch->Submit();
+	} else {
+		variant.reset(new Shader(Shader::FromSource(vertex.c_str(), fragment.c_str())));
+	}
+	if (reloader != NULL) {
+		reloader->Watch(*variant, vertexFile, fragmentFile, defines);
+	}
+	return *variant;
+}
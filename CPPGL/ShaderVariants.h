@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Shader;
+class ShaderBatch;
+class ShaderReloader;
+
+// one material's vertex and fragment source built with any combination of its
+// features, each feature being a #define the source can #ifdef on. a variant is
+// asked for by the bitmask of features it wants, and only preprocessed and
+// compiled the first time that mask comes up, so a material with 8 features
+// doesn't compile 256 programs up front, just the ones something draws with
+class ShaderVariants {
+public:
+	struct Stats {
+		unsigned int requests;
+		// distinct variants built, the rest of the requests were already there
+		unsigned int compiled;
+		// reading, #including and defining, the compile time is in ProgramCache's report
+		double preprocessMs;
+	};
+
+	// at most 32 features, bit i is features[i]. with a batch the variants come
+	// back PENDING and compile in the background, otherwise Get compiles them
+	// there and then. with a reloader each one is hot reloaded too
+	ShaderVariants(const std::string &vertexFile, const std::string &fragmentFile,
+		const std::vector<std::string> &features, ShaderBatch *batch = NULL, ShaderReloader *reloader = NULL);
+	~ShaderVariants();
+	ShaderVariants(const ShaderVariants &) = delete;
+	ShaderVariants &operator=(const ShaderVariants &) = delete;
+
+	// the bit for a feature, 0 (and it's printed) if there's no such feature
+	uint32_t Bit(const std::string &feature) const;
+	// the variant with exactly these features defined. the reference stays valid
+	// as long as this does. FAILED if it doesn't compile, or a file is missing
+	Shader &Get(uint32_t mask);
+	bool Has(uint32_t mask) const { return variants.count(mask) != 0; }
+	size_t Compiled() const { return variants.size(); }
+	// the defines a mask turns into
+	std::vector<std::string> Defines(uint32_t mask) const;
+
+	Stats GetStats() const { return stats; }
+
+private:
+	std::string vertexFile;
+	std::string fragmentFile;
+	std::vector<std::string> features;
+	ShaderBatch *batch;
+	ShaderReloader *reloader;
+	// pointers so the Shaders don't move when the map grows
+	std::unordered_map<uint32_t, std::unique_ptr<Shader>> variants;
+	Stats stats;
+};
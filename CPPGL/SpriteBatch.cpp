@@ -0,0 +1,128 @@
+#include "SpriteBatch.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+#include <cstddef>
+#include <cstring>
+
+// every sprite is the same quad, so the indices are built once for the whole buffer
+// the element buffer gets recorded into the bound VAO, so this binds vao first
+static std::vector<GLuint> quadIndices(VAO &vao, GLsizei capacity) {
+	vao.Bind();
+	std::vector<GLuint> elements(capacity * 6);
+	for (GLsizei i = 0; i < capacity; i++) {
+		GLuint corner = i * 4;
+		// same winding as the scene's quad
+		elements[i * 6 + 0] = corner + 0;
+		elements[i * 6 + 1] = corner + 2;
+		elements[i * 6 + 2] = corner + 1;
+		elements[i * 6 + 3] = corner + 0;
+		elements[i * 6 + 4] = corner + 3;
+		elements[i * 6 + 5] = corner + 2;
+	}
+	return elements;
+}
+
+SpriteBatch::SpriteBatch(Shader &spriteShader, GLsizei spriteCapacity)
+	: SpriteBatch(spriteShader, spriteCapacity,
+		GLExtensions::ARB_buffer_storage ? StreamBuffer::PERSISTENT : StreamBuffer::UNSYNCHRONIZED)
+{
+}
+
+SpriteBatch::SpriteBatch(Shader &spriteShader, GLsizei spriteCapacity, StreamBuffer::Mode mode)
+	: shader(spriteShader),
+	stream(GL_ARRAY_BUFFER, spriteCapacity * 4 * sizeof(SpriteVertex), 3, mode),
+	ebo(quadIndices(vao, spriteCapacity).data(), spriteCapacity * 6 * sizeof(GLuint)),
+	sampler(0),
+	capacity(spriteCapacity),
+	currentTexture(0),
+	textureTarget(GL_TEXTURE_2D),
+	viewSizeUniform(-1),
+	stats()
+{
+	GLsizei stride = sizeof(SpriteVertex);
+	vao.LinkAttrib(stream.vbo, 0, 2, GL_FLOAT, stride, (void*)offsetof(SpriteVertex, x));
+	// colors go up as bytes and come out as 0..1 floats
+	vao.LinkAttrib(stream.vbo, 1, 4, GL_UNSIGNED_BYTE, stride, (void*)offsetof(SpriteVertex, r), GL_TRUE);
+	vao.LinkAttrib(stream.vbo, 2, 2, GL_FLOAT, stride, (void*)offsetof(SpriteVertex, u));
+	// the layer comes out as a float, which is what texture() wants for an array anyway
+	vao.LinkAttrib(stream.vbo, 3, 1, GL_UNSIGNED_SHORT, stride, (void*)offsetof(SpriteVertex, layer));
+	vao.Unbind();
+	stream.vbo.Unbind();
+	ebo.Unbind();
+
+	vertices.reserve(capacity * 4);
+}
+
+void SpriteBatch::Begin(GLfloat viewWidth, GLfloat viewHeight) {
+	stats = Stats();
+	vertices.clear();
+	currentTexture = 0;
+
+	// the shader might have been compiled in a batch, so look these up late
+	if (viewSizeUniform < 0 && shader.Ready()) {
+		viewSizeUniform = shader.Uniform("viewSize");
+		UniformHandle tex0 = shader.Uniform("tex0");
+		shader.Set(tex0, 0);
+		if (tex0 >= 0 && shader.Uniforms()[tex0].type == GL_SAMPLER_2D_ARRAY) {
+			textureTarget = GL_TEXTURE_2D_ARRAY;
+		}
+	}
+	shader.Set(viewSizeUniform, viewWidth, viewHeight);
+}
+
+void SpriteBatch::Draw(GLuint texture, GLfloat x, GLfloat y, GLfloat width, GLfloat height,
+	UVRect uv, GLubyte r, GLubyte g, GLubyte b, GLubyte a) {
+	DrawLayer(texture, 0, x, y, width, height, uv, r, g, b, a);
+}
+
+void SpriteBatch::DrawLayer(GLuint texture, GLushort layer, GLfloat x, GLfloat y, GLfloat width, GLfloat height,
+	UVRect uv, GLubyte r, GLubyte g, GLubyte b, GLubyte a) {
+	if (texture != currentTexture && !vertices.empty()) {
+		stats.textureFlushes++;
+		flush();
+	} else if (vertices.size() == (size_t)capacity * 4) {
+		stats.capacityFlushes++;
+		flush();
+	}
+	currentTexture = texture;
+
+	// lower left, upper left, upper right, lower right, like the scene's quad
+	vertices.push_back({ x, y, r, g, b, a, uv.u0, uv.v0, layer, 0 });
+	vertices.push_back({ x, y + height, r, g, b, a, uv.u0, uv.v1, layer, 0 });
+	vertices.push_back({ x + width, y + height, r, g, b, a, uv.u1, uv.v1, layer, 0 });
+	vertices.push_back({ x + width, y, r, g, b, a, uv.u1, uv.v0, layer, 0 });
+	stats.sprites++;
+}
+
+void SpriteBatch::End() {
+	flush();
+	stream.EndFrame();
+}
+
+void SpriteBatch::flush() {
+	if (vertices.empty() || !shader.Ready()) {
+		vertices.clear();
+		return;
+	}
+	GLsizeiptr bytes = vertices.size() * sizeof(SpriteVertex);
+
+	// aligned to whole vertices so the offset can be turned into a base vertex
+	GLintptr offset = 0;
+	void *target = stream.Map(bytes, offset, sizeof(SpriteVertex));
+	if (target == NULL) {
+		vertices.clear();
+		return;
+	}
+	memcpy(target, vertices.data(), bytes);
+	stream.Unmap();
+
+	shader.Activate();
+	GLState::BindTexture(0, textureTarget, currentTexture);
+	GLState::BindSampler(0, sampler);
+	vao.Bind();
+	glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)(vertices.size() / 4 * 6), GL_UNSIGNED_INT, 0,
+		(GLint)(offset / sizeof(SpriteVertex)));
+	stats.draws++;
+
+	vertices.clear();
+}
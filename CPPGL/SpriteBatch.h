@@ -0,0 +1,78 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include "shaderClass.h"
+#include "VAO.h"
+#include "StreamBuffer.h"
+#include "EBO.h"
+
+// one corner of a sprite as it sits in the vertex buffer, 24 bytes
+struct SpriteVertex {
+	GLfloat x, y;
+	GLubyte r, g, b, a;
+	GLfloat u, v;
+	// texture array layer, ignored by shaders that sample a plain 2D texture
+	GLushort layer;
+	GLushort padding;
+};
+
+// texture coordinates of the part of a texture a sprite shows
+struct UVRect {
+	GLfloat u0, v0, u1, v1;
+};
+
+// collects sprites into one streaming vertex buffer and draws them with as few
+// glDrawElements calls as it can: a draw only happens when the texture changes,
+// the buffer fills up, or End() is called. the index buffer never changes since
+// every sprite is the same two triangles, and each draw picks its vertices out
+// of the stream buffer with a base vertex instead of re-pointing the attributes.
+// with sprite_array.vert/frag the texture is a TextureArray and every sprite
+// picks its own layer, so different images don't need a texture change at all
+class SpriteBatch {
+public:
+	struct Stats {
+		unsigned int draws;
+		unsigned int sprites;
+		// why each draw happened
+		unsigned int textureFlushes;
+		unsigned int capacityFlushes;
+	};
+
+	Shader &shader;
+	VAO vao;
+	StreamBuffer stream;
+	EBO ebo;
+	// bound with the texture, from Samplers. 0 uses the texture's own parameters
+	GLuint sampler;
+
+	// shader needs the sprite.vert inputs and viewSize/tex0 uniforms. a tex0 that's
+	// a sampler2DArray makes the batch bind GL_TEXTURE_2D_ARRAY instead
+	// capacity is how many sprites fit in one draw, and one stream region
+	SpriteBatch(Shader &shader, GLsizei capacity = 16384);
+	SpriteBatch(Shader &shader, GLsizei capacity, StreamBuffer::Mode mode);
+
+	// viewSize is the pixel size sprite positions are relative to
+	void Begin(GLfloat viewWidth, GLfloat viewHeight);
+	void Draw(GLuint texture, GLfloat x, GLfloat y, GLfloat width, GLfloat height,
+		UVRect uv = { 0.0f, 0.0f, 1.0f, 1.0f },
+		GLubyte r = 255, GLubyte g = 255, GLubyte b = 255, GLubyte a = 255);
+	// same, showing one layer of a texture array
+	void DrawLayer(GLuint texture, GLushort layer, GLfloat x, GLfloat y, GLfloat width, GLfloat height,
+		UVRect uv = { 0.0f, 0.0f, 1.0f, 1.0f },
+		GLubyte r = 255, GLubyte g = 255, GLubyte b = 255, GLubyte a = 255);
+	// draws whatever is left and fences this frame's part of the stream buffer,
+	// then Stats covers everything since Begin
+	void End();
+	Stats GetStats() const { return stats; }
+
+private:
+	GLsizei capacity;
+	std::vector<SpriteVertex> vertices;
+	GLuint currentTexture;
+	GLenum textureTarget;
+	UniformHandle viewSizeUniform;
+	Stats stats;
+
+	void flush();
+};
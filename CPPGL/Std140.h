@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+
+// types for C++ structs that mirror a layout(std140) uniform block byte for byte.
+// std140 puts vec2 on 8 bytes, vec3/vec4/mat4 and every array element on 16,
+// and the alignas here makes the compiler do the same. a vec3 still takes 16
+// bytes in C++ where GLSL would fit a float after it, so follow a vec3 with a
+// vec3/vec4 or just use a vec4. the STD140 macros then check the result at compile time
+namespace std140 {
+	struct alignas(8) vec2 {
+		GLfloat x, y;
+	};
+	struct alignas(16) vec3 {
+		GLfloat x, y, z;
+	};
+	struct alignas(16) vec4 {
+		GLfloat x, y, z, w;
+	};
+	struct alignas(8) ivec2 {
+		GLint x, y;
+	};
+	struct alignas(16) ivec4 {
+		GLint x, y, z, w;
+	};
+	// column major, four vec4 columns
+	struct alignas(16) mat4 {
+		GLfloat m[16];
+	};
+	// one element of a float/int array, which std140 pads out to a vec4
+	template<typename T>
+	struct alignas(16) element {
+		T value;
+	};
+}
+
+// the member sits where the GLSL block puts it, copy the offsets from the std140 rules
+#define STD140_OFFSET(Type, member, offset) \
+	static_assert(offsetof(Type, member) == (offset), #Type "::" #member " isn't at std140 offset " #offset)
+// the whole struct is the block's size, which std140 rounds up to 16
+#define STD140_SIZE(Type, size) \
+	static_assert(sizeof(Type) == (size) && sizeof(Type) % 16 == 0, #Type " isn't " #size " bytes like its std140 block")
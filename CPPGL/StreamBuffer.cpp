@@ -0,0 +1,167 @@
+#include "StreamBuffer.h"
+#include "GLExtensions.h"
+#include "GLObjects.h"
+#include "GLState.h"
+#include "Timing.h"
+#include <chrono>
+
+StreamBuffer::StreamBuffer(GLenum bufferTarget, GLsizeiptr size, int regionCount)
+	: StreamBuffer(bufferTarget, size, regionCount,
+		GLExtensions::ARB_buffer_storage ? PERSISTENT : UNSYNCHRONIZED)
+{
+}
+
+StreamBuffer::StreamBuffer(GLenum bufferTarget, GLsizeiptr size, int regionCount, Mode streamMode)
+	// starts out as an empty buffer, allocate() gives it its real storage
+	: vbo(NULL, 0),
+	target(bufferTarget),
+	mode(streamMode),
+	regionSize(size),
+	regions(regionCount < 1 ? 1 : (regionCount > MAX_REGIONS ? MAX_REGIONS : regionCount)),
+	region(0),
+	head(0),
+	fences(),
+	persistent(NULL),
+	mapped(false),
+	stats()
+{
+	if (mode == PERSISTENT && !GLExtensions::ARB_buffer_storage) {
+		mode = UNSYNCHRONIZED;
+	}
+	allocate();
+}
+
+StreamBuffer::~StreamBuffer() {
+	Delete();
+}
+
+void StreamBuffer::allocate() {
+	GLsizeiptr total = regionSize * regions;
+	vbo.size = total;
+	vbo.capacity = total;
+	GLObjects::Resized(GLObjects::BUFFER, vbo.ID, total);
+	Bind();
+	if (mode == PERSISTENT) {
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(target, total, NULL, flags);
+		persistent = (char*)glMapBufferRange(target, 0, total, flags);
+		if (persistent == NULL) {
+			// no immutable storage can be respecified, so start over with a new buffer
+			vbo = VBO(NULL, 0);
+			mode = UNSYNCHRONIZED;
+			allocate();
+		}
+	} else {
+		glBufferData(target, total, NULL, GL_STREAM_DRAW);
+	}
+}
+
+void *StreamBuffer::Map(GLsizeiptr size, GLintptr &offset, GLsizeiptr alignment) {
+	GLsizeiptr regionStart = region * regionSize;
+	GLsizeiptr start = (regionStart + head + alignment - 1) / alignment * alignment - regionStart;
+	if (start + size > regionSize) {
+		// doesn't fit what's left of this frame's region
+		stats.overflows++;
+		advance();
+		regionStart = region * regionSize;
+		start = (regionStart + alignment - 1) / alignment * alignment - regionStart;
+		if (start + size > regionSize) {
+			return NULL;
+		}
+	}
+	offset = regionStart + start;
+	head = start + size;
+	stats.bytesWritten += size;
+
+	if (mode == PERSISTENT) {
+		return persistent + offset;
+	}
+	Bind();
+	GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+	if (mode == UNSYNCHRONIZED) {
+		// the region fence already guarantees the GPU is done with these bytes
+		access |= GL_MAP_UNSYNCHRONIZED_BIT;
+	}
+	void *pointer = glMapBufferRange(target, offset, size, access);
+	// a failed map leaves nothing for Unmap to undo
+	mapped = pointer != NULL;
+	return pointer;
+}
+
+void StreamBuffer::Unmap() {
+	// coherent persistent mappings need nothing, writes are visible to the next draw
+	if (mapped) {
+		Bind();
+		glUnmapBuffer(target);
+		mapped = false;
+	}
+}
+
+void StreamBuffer::EndFrame() {
+	advance();
+}
+
+void StreamBuffer::advance() {
+	if (mode == ORPHAN) {
+		// no fences, just wrap around and hand the old storage back to the driver
+		region = (region + 1) % regions;
+		head = 0;
+		if (region == 0) {
+			Bind();
+			glBufferData(target, regionSize * regions, NULL, GL_STREAM_DRAW);
+		}
+		return;
+	}
+
+	if (fences[region] != NULL) {
+		glDeleteSync(fences[region]);
+	}
+	fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	region = (region + 1) % regions;
+	head = 0;
+
+	GLsync fence = fences[region];
+	if (fence == NULL) {
+		return;
+	}
+	// usually the GPU finished with this region a couple of frames ago
+	GLenum result = glClientWaitSync(fence, 0, 0);
+	if (result == GL_TIMEOUT_EXPIRED) {
+		stats.stalls++;
+		auto start = std::chrono::steady_clock::now();
+		do {
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+		} while (result == GL_TIMEOUT_EXPIRED);
+		stats.stallMs += millisecondsSince(start);
+	}
+	glDeleteSync(fence);
+	fences[region] = NULL;
+}
+
+void StreamBuffer::Bind() {
+	GLState::BindBuffer(target, vbo.ID);
+}
+
+const char *StreamBuffer::ModeName(Mode mode) {
+	switch (mode) {
+	case PERSISTENT: return "persistent";
+	case UNSYNCHRONIZED: return "unsynchronized";
+	default: return "orphan";
+	}
+}
+
+void StreamBuffer::Delete() {
+	for (GLsync &fence : fences) {
+		if (fence != NULL) {
+			glDeleteSync(fence);
+			fence = NULL;
+		}
+	}
+	if (persistent != NULL || mapped) {
+		Bind();
+		glUnmapBuffer(target);
+		persistent = NULL;
+		mapped = false;
+	}
+	vbo.Delete();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "VBO.h"
+
+// a buffer for data that's rewritten every frame. it's split into regions
+// (three by default, one per frame in flight) and each region gets a fence when
+// the frame using it is done, so the CPU only ever writes bytes the GPU has
+// finished reading. with ARB_buffer_storage the whole thing is mapped once,
+// persistent and coherent; without it each write maps its range unsynchronized,
+// which the fences make safe. ORPHAN skips the fences and lets the driver hand
+// out fresh storage instead, for comparison or drivers where that's faster.
+// it can't be copied or moved, the fences and the mapping belong to this one
+class StreamBuffer {
+public:
+	enum Mode {
+		PERSISTENT,
+		UNSYNCHRONIZED,
+		ORPHAN
+	};
+
+	struct Stats {
+		unsigned long long bytesWritten;
+		// times we had to wait on a region the GPU was still reading
+		unsigned int stalls;
+		double stallMs;
+		// allocations that didn't fit the rest of their region and moved on early
+		unsigned int overflows;
+	};
+
+	// the data lives in a VBO so VAO::LinkAttrib can point at it like any other buffer
+	VBO vbo;
+	GLenum target;
+	Mode mode;
+
+	// picks PERSISTENT when the driver has ARB_buffer_storage, UNSYNCHRONIZED otherwise
+	StreamBuffer(GLenum target, GLsizeiptr regionSize, int regions = 3);
+	StreamBuffer(GLenum target, GLsizeiptr regionSize, int regions, Mode mode);
+	~StreamBuffer();
+	StreamBuffer(const StreamBuffer &) = delete;
+	StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+	// room for size bytes in the current region, aligned to alignment from the start
+	// of the buffer. offset is where the data will sit, for draws and attrib pointers.
+	// write to the returned pointer, then call Unmap before drawing from it
+	void *Map(GLsizeiptr size, GLintptr &offset, GLsizeiptr alignment = 4);
+	void Unmap();
+	// fences the current region and moves to the next, once per frame after the
+	// frame's draws have been issued
+	void EndFrame();
+
+	void Bind();
+	GLsizeiptr RegionSize() const { return regionSize; }
+	Stats GetStats() const { return stats; }
+	void ResetStats() { stats = Stats(); }
+	static const char *ModeName(Mode mode);
+	// unmaps and frees everything early, the destructor does it otherwise
+	void Delete();
+
+private:
+	static const int MAX_REGIONS = 8;
+
+	GLsizeiptr regionSize;
+	int regions;
+	int region;
+	// next free byte inside the current region
+	GLsizeiptr head;
+	GLsync fences[MAX_REGIONS];
+	// persistent mode keeps the whole buffer mapped for its lifetime
+	char *persistent;
+	bool mapped;
+	Stats stats;
+
+	void allocate();
+	void advance();
+};
@@ -0,0 +1,284 @@
+#include "Texture.h"
+#include "AssetArchive.h"
+#include "CookedTexture.h"
+#include "GLExtensions.h"
+#include "GLObjects.h"
+#include "GLState.h"
+#include "MappedFile.h"
+#include "TextureLoader.h"
+#include "TextureResidency.h"
+#include "stb/stb_image.h"
+#include <iostream>
+#include <utility>
+#include <vector>
+
+Texture::Texture()
+	: ID(0), width(0), height(0), status(PENDING), premultiplied(false), format(GL_RGBA8), filter(GL_NEAREST),
+	wrap(GL_CLAMP_TO_EDGE), loader(NULL), loadId(0), residency(NULL), levels(0)
+{
+}
+
+void Texture::create(GLint textureFilter, GLint textureWrap) {
+	filter = textureFilter;
+	wrap = textureWrap;
+	glGenTextures(1, &ID);
+	GLObjects::Created(GLObjects::TEXTURE, ID, 0);
+	GLState::BindTexture(GL_TEXTURE_2D, ID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+	// ST = U(1-V)
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+}
+
+Texture::Texture(const char *file, GLint textureFilter, GLint textureWrap) : Texture() {
+	create(textureFilter, textureWrap);
+	int imgWidth, imgHeight, imgColChannels;
+	// always ask for 4 channels, stb fills in alpha for rgb files so the upload can assume rgba
+	unsigned char *bytes = stbi_load(file, &imgWidth, &imgHeight, &imgColChannels, 4);
+	if (bytes == NULL) {
+		std::cout << "couldn't load texture " << file << ": " << stbi_failure_reason() << std::endl;
+		status = FAILED;
+		return;
+	}
+	allocate(imgWidth, imgHeight);
+	uploadRows(0, bytes, 0, imgHeight);
+	finish(true);
+	stbi_image_free(bytes);
+}
+
+Texture::Texture(const char *file, TextureLoader &textureLoader, GLint textureFilter, GLint textureWrap)
+	: Texture()
+{
+	create(textureFilter, textureWrap);
+	loader = &textureLoader;
+	loadId = loader->Add(this, file);
+}
+
+Texture::Texture(const unsigned char *pixels, GLsizei pixelWidth, GLsizei pixelHeight,
+	GLint textureFilter, GLint textureWrap)
+	: Texture()
+{
+	create(textureFilter, textureWrap);
+	allocate(pixelWidth, pixelHeight);
+	uploadRows(0, pixels, 0, pixelHeight);
+	finish(true);
+}
+
+Texture::Texture(GLsizei pixelWidth, GLsizei pixelHeight, GLint textureFilter, GLint textureWrap, GLint levelCount)
+	: Texture()
+{
+	create(textureFilter, textureWrap);
+	allocate(pixelWidth, pixelHeight);
+	if (levelCount > 0 && levelCount < levels) {
+		levels = levelCount;
+		// otherwise sampling would want the levels that were never allocated
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+		GLObjects::Resized(GLObjects::TEXTURE, ID, Bytes());
+	}
+	allocateMips();
+	status = READY;
+}
+
+Texture Texture::FromCooked(const char *file, GLint textureFilter, GLint textureWrap) {
+	Texture texture;
+	texture.create(textureFilter, textureWrap);
+	MappedFile mapped(file);
+	if (!mapped.IsOpen()) {
+		texture.status = FAILED;
+		return texture;
+	}
+	texture.uploadCooked(file, mapped.Data(), mapped.Size());
+	return texture;
+}
+
+Texture Texture::FromCooked(const AssetArchive &assets, const char *name, GLint textureFilter,
+	GLint textureWrap)
+{
+	Texture texture;
+	texture.create(textureFilter, textureWrap);
+	AssetArchive::View view = assets.Find(name);
+	if (!view.Found()) {
+		std::cout << "couldn't load texture " << name << ": it isn't in the asset archive" << std::endl;
+		texture.status = FAILED;
+		return texture;
+	}
+	if (view.compression == AssetArchive::NONE) {
+		texture.uploadCooked(name, view.data, view.size);
+		return texture;
+	}
+	std::vector<unsigned char> bytes;
+	if (!assets.Read(name, bytes)) {
+		texture.status = FAILED;
+		return texture;
+	}
+	texture.uploadCooked(name, bytes.data(), bytes.size());
+	return texture;
+}
+
+void Texture::uploadCooked(const char *file, const unsigned char *bytes, size_t size) {
+	CookedTexture::View cooked;
+	if (!CookedTexture::Parse(bytes, size, cooked)) {
+		std::cout << "couldn't load texture " << file << ": not a cooked texture, or cooked by another version"
+			<< std::endl;
+		status = FAILED;
+		return;
+	}
+	BlockCompression::Format compression;
+	bool compressed = BlockCompression::FromGLFormat(cooked.header->format, compression);
+	if (compressed && !(compression == BlockCompression::BC7 ? GLExtensions::texture_compression_bptc
+		: GLExtensions::EXT_texture_compression_s3tc))
+	{
+		std::cout << "couldn't load texture " << file << ": the driver can't sample "
+			<< (compression == BlockCompression::BC7 ? "BC7" : "S3TC") << " textures" << std::endl;
+		status = FAILED;
+		return;
+	}
+
+	width = (GLsizei)cooked.header->width;
+	height = (GLsizei)cooked.header->height;
+	levels = (GLint)cooked.header->levels;
+	premultiplied = (cooked.header->flags & CookedTexture::PREMULTIPLIED) != 0;
+	format = cooked.header->format;
+	GLState::BindTexture(GL_TEXTURE_2D, ID);
+	for (GLint level = 0; level < levels; level++) {
+		const CookedTexture::Level &info = cooked.levels[level];
+		if (compressed) {
+			glCompressedTexImage2D(GL_TEXTURE_2D, level, format, info.width, info.height, 0,
+				(GLsizei)BlockCompression::LevelBytes(format, info.width, info.height), cooked.Pixels(level));
+		} else {
+			glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, info.width, info.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+				cooked.Pixels(level));
+		}
+	}
+	// a cook with fewer levels than the full chain
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+	GLObjects::Resized(GLObjects::TEXTURE, ID, Bytes());
+	status = READY;
+}
+
+Texture::~Texture() {
+	Delete();
+}
+
+Texture::Texture(Texture &&other) noexcept : Texture() {
+	take(other);
+}
+
+Texture &Texture::operator=(Texture &&other) noexcept {
+	if (this != &other) {
+		Delete();
+		take(other);
+	}
+	return *this;
+}
+
+void Texture::take(Texture &other) {
+	ID = other.ID;
+	width = other.width;
+	height = other.height;
+	status = other.status;
+	premultiplied = other.premultiplied;
+	format = other.format;
+	filter = other.filter;
+	wrap = other.wrap;
+	loader = other.loader;
+	loadId = other.loadId;
+	levels = other.levels;
+	// the loader uploads through the pointer it was given, point it here now
+	if (loader != NULL) {
+		loader->Replace(loadId, this);
+	}
+	residency = other.residency;
+	if (residency != NULL) {
+		residency->Replace(&other, this);
+	}
+
+	other.ID = 0;
+	other.status = FAILED;
+	other.loader = NULL;
+	other.residency = NULL;
+}
+
+void Texture::swapStorage(Texture &other) {
+	std::swap(ID, other.ID);
+	std::swap(width, other.width);
+	std::swap(height, other.height);
+	std::swap(format, other.format);
+	std::swap(levels, other.levels);
+}
+
+size_t Texture::Bytes() const {
+	size_t bytes = 0;
+	for (GLint level = 0; level < levels; level++) {
+		uint32_t levelWidth = width >> level > 0 ? width >> level : 1;
+		uint32_t levelHeight = height >> level > 0 ? height >> level : 1;
+		bytes += BlockCompression::LevelBytes(format, levelWidth, levelHeight);
+	}
+	return bytes;
+}
+
+void Texture::allocate(GLsizei pixelWidth, GLsizei pixelHeight) {
+	width = pixelWidth;
+	height = pixelHeight;
+	// a full chain, down to 1x1
+	levels = 1;
+	for (GLsizei size = width > height ? width : height; size > 1; size >>= 1) {
+		levels++;
+	}
+	GLState::BindTexture(GL_TEXTURE_2D, ID);
+	// storage only, the pixels come in afterwards a few rows at a time
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	GLObjects::Resized(GLObjects::TEXTURE, ID, Bytes());
+}
+
+void Texture::allocateMips() {
+	GLState::BindTexture(GL_TEXTURE_2D, ID);
+	// the smaller levels need storage too, or uploading straight into them fails
+	for (GLint level = 1; level < levels; level++) {
+		GLsizei levelWidth = width >> level > 0 ? width >> level : 1;
+		GLsizei levelHeight = height >> level > 0 ? height >> level : 1;
+		glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, levelWidth, levelHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	}
+}
+
+void Texture::uploadRows(GLint level, const unsigned char *pixels, GLsizei firstRow, GLsizei rows) {
+	GLState::BindTexture(GL_TEXTURE_2D, ID);
+	GLsizei levelWidth = width >> level > 0 ? width >> level : 1;
+	const unsigned char *start = pixels + (size_t)firstRow * levelWidth * 4;
+	glTexSubImage2D(GL_TEXTURE_2D, level, 0, firstRow, levelWidth, rows, GL_RGBA, GL_UNSIGNED_BYTE, start);
+}
+
+void Texture::finish(bool generateMips) {
+	if (generateMips) {
+		GenerateMipmaps();
+	}
+	status = READY;
+}
+
+void Texture::GenerateMipmaps() {
+	GLState::BindTexture(GL_TEXTURE_2D, ID);
+	glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+void Texture::Bind(GLuint unit) {
+	GLState::BindTexture(unit, GL_TEXTURE_2D, ID);
+}
+
+void Texture::Delete() {
+	if (loader != NULL) {
+		loader->Remove(loadId);
+		loader = NULL;
+	}
+	if (residency != NULL) {
+		residency->Forget(this);
+		residency = NULL;
+	}
+	status = FAILED;
+	if (ID != 0) {
+		glDeleteTextures(1, &ID);
+		GLState::TextureDeleted(ID);
+		GLObjects::Deleted(GLObjects::TEXTURE, ID);
+		ID = 0;
+	}
+}
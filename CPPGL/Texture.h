@@ -0,0 +1,100 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+
+class AssetArchive;
+class TextureLoader;
+class TextureResidency;
+
+// an rgba8 (or, cooked, block compressed) GL_TEXTURE_2D with a full mip
+// chain. it's freed when it goes out of scope, moves hand over the ID (and its
+// place in the loader if it's still loading, or in a TextureResidency if it's
+// managed), copies aren't allowed
+class Texture {
+public:
+	enum Status {
+		PENDING, // still decoding or uploading, binds fine but samples as black
+		READY,
+		FAILED // the file couldn't be read or decoded, the reason has been printed
+	};
+
+	GLuint ID;
+	GLsizei width;
+	GLsizei height;
+	Status status;
+	// rgb already multiplied by alpha, only cooked textures can be
+	bool premultiplied;
+	// GL_RGBA8, or a block compressed format if it was cooked as one
+	GLenum format;
+	// what it was created with, min and mag filter alike and the same wrap on s and t
+	GLint filter;
+	GLint wrap;
+
+	// decodes and uploads right away, on this thread
+	Texture(const char *file, GLint filter = GL_NEAREST, GLint wrap = GL_CLAMP_TO_EDGE);
+	// hands the file to the loader's threads, the texture stays PENDING until the
+	// loader's Update has uploaded all of it
+	Texture(const char *file, TextureLoader &loader, GLint filter = GL_NEAREST, GLint wrap = GL_CLAMP_TO_EDGE);
+	// from rgba pixels already in memory
+	Texture(const unsigned char *pixels, GLsizei width, GLsizei height,
+		GLint filter = GL_NEAREST, GLint wrap = GL_CLAMP_TO_EDGE);
+	// storage but no pixels, to be filled in with a TextureUploader. levels 0 means
+	// the full mip chain, 1 just the base level
+	Texture(GLsizei width, GLsizei height, GLint filter = GL_NEAREST, GLint wrap = GL_CLAMP_TO_EDGE,
+		GLint levels = 0);
+	// maps a .ctex from cppgl_cook and uploads its levels straight from the
+	// mapping, no decoding and no glGenerateMipmap. FAILED if it can't be read,
+	// or it's block compressed in a format this context can't sample
+	static Texture FromCooked(const char *file, GLint filter = GL_NEAREST, GLint wrap = GL_CLAMP_TO_EDGE);
+	// the same from a .ctex packed into an asset archive, uploaded straight from
+	// its mapping unless it was packed compressed
+	static Texture FromCooked(const AssetArchive &assets, const char *name, GLint filter = GL_NEAREST,
+		GLint wrap = GL_CLAMP_TO_EDGE);
+	~Texture();
+	Texture(Texture &&other) noexcept;
+	Texture &operator=(Texture &&other) noexcept;
+	Texture(const Texture &) = delete;
+	Texture &operator=(const Texture &) = delete;
+
+	bool Ready() const { return status == READY; }
+	// what it takes up on the GPU, mips included
+	size_t Bytes() const;
+	// how many mip levels it has storage for
+	GLint Levels() const { return levels; }
+	// rebuilds every level below the base from the base level
+	void GenerateMipmaps();
+
+	void Bind(GLuint unit);
+	// frees it early, the destructor does it otherwise
+	void Delete();
+
+private:
+	friend class TextureLoader;
+	friend class TextureResidency;
+
+	// only set while the texture is PENDING on a loader
+	TextureLoader *loader;
+	unsigned int loadId;
+	// only set while a TextureResidency manages it
+	TextureResidency *residency;
+	GLint levels;
+
+	Texture();
+	// makes the GL texture and sets its filtering, no storage yet
+	void create(GLint filter, GLint wrap);
+	void allocate(GLsizei width, GLsizei height);
+	// storage for every level below the base, for mips made on the cpu
+	void allocateMips();
+	// rows of a tightly packed rgba image of that level's size, starting at firstRow
+	void uploadRows(GLint level, const unsigned char *pixels, GLsizei firstRow, GLsizei rows);
+	// once every row is in. generateMips builds the chain from the base level,
+	// otherwise it's been uploaded already
+	void finish(bool generateMips);
+	// every level of a cooked texture, file is only for the messages
+	void uploadCooked(const char *file, const unsigned char *bytes, size_t size);
+	void take(Texture &other);
+	// trades GL textures with other, keeping everything else (the loader and
+	// residency registrations) where it was
+	void swapStorage(Texture &other);
+};
@@ -0,0 +1,153 @@
+#include "TextureArray.h"
+#include "GLObjects.h"
+#include "GLState.h"
+#include "stb/stb_image.h"
+#include <iostream>
+
+TextureArray::TextureArray() : ID(0), width(0), height(0), layers(0), levels(0) {
+}
+
+TextureArray::TextureArray(GLsizei layerWidth, GLsizei layerHeight, GLsizei layerCount, GLint levelCount)
+	: TextureArray()
+{
+	allocate(layerWidth, layerHeight, layerCount, levelCount);
+}
+
+TextureArray::TextureArray(const char *sheetFile, GLsizei tileWidth, GLsizei tileHeight, GLint levelCount)
+	: TextureArray()
+{
+	int sheetWidth, sheetHeight, channels;
+	unsigned char *sheet = stbi_load(sheetFile, &sheetWidth, &sheetHeight, &channels, 4);
+	if (sheet == NULL) {
+		std::cout << "couldn't load sprite sheet " << sheetFile << ": " << stbi_failure_reason() << std::endl;
+		return;
+	}
+	int columns = sheetWidth / tileWidth;
+	int rows = sheetHeight / tileHeight;
+	allocate(tileWidth, tileHeight, columns * rows, levelCount);
+	for (int row = 0; row < rows; row++) {
+		for (int column = 0; column < columns; column++) {
+			const unsigned char *tile = sheet + ((size_t)row * tileHeight * sheetWidth + column * tileWidth) * 4;
+			SetLayer(row * columns + column, tile, sheetWidth);
+		}
+	}
+	stbi_image_free(sheet);
+	if (levels > 1) {
+		GenerateMipmaps();
+	}
+}
+
+TextureArray::TextureArray(const std::vector<std::string> &files, GLint levelCount) : TextureArray() {
+	for (size_t i = 0; i < files.size(); i++) {
+		int imgWidth, imgHeight, channels;
+		unsigned char *bytes = stbi_load(files[i].c_str(), &imgWidth, &imgHeight, &channels, 4);
+		if (bytes == NULL) {
+			std::cout << "couldn't load texture " << files[i] << ": " << stbi_failure_reason() << std::endl;
+			continue;
+		}
+		// the first file decides the size
+		if (ID == 0) {
+			allocate(imgWidth, imgHeight, (GLsizei)files.size(), levelCount);
+		}
+		if (imgWidth != width || imgHeight != height) {
+			std::cout << "texture array layer " << files[i] << " is " << imgWidth << "x" << imgHeight
+				<< ", the array is " << width << "x" << height << std::endl;
+		} else {
+			SetLayer((GLsizei)i, bytes);
+		}
+		stbi_image_free(bytes);
+	}
+	if (levels > 1) {
+		GenerateMipmaps();
+	}
+}
+
+TextureArray::~TextureArray() {
+	Delete();
+}
+
+TextureArray::TextureArray(TextureArray &&other) noexcept
+	: ID(other.ID), width(other.width), height(other.height), layers(other.layers), levels(other.levels)
+{
+	other.ID = 0;
+	other.layers = 0;
+}
+
+TextureArray &TextureArray::operator=(TextureArray &&other) noexcept {
+	if (this != &other) {
+		Delete();
+		ID = other.ID;
+		width = other.width;
+		height = other.height;
+		layers = other.layers;
+		levels = other.levels;
+		other.ID = 0;
+		other.layers = 0;
+	}
+	return *this;
+}
+
+void TextureArray::allocate(GLsizei layerWidth, GLsizei layerHeight, GLsizei layerCount, GLint levelCount) {
+	width = layerWidth;
+	height = layerHeight;
+	layers = layerCount;
+	GLint fullChain = 1;
+	for (GLsizei size = width > height ? width : height; size > 1; size >>= 1) {
+		fullChain++;
+	}
+	levels = levelCount > 0 && levelCount < fullChain ? levelCount : fullChain;
+
+	glGenTextures(1, &ID);
+	GLState::BindTexture(GL_TEXTURE_2D_ARRAY, ID);
+	for (GLint level = 0; level < levels; level++) {
+		GLsizei levelWidth = width >> level > 0 ? width >> level : 1;
+		GLsizei levelHeight = height >> level > 0 ? height >> level : 1;
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA, levelWidth, levelHeight, layers, 0,
+			GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	}
+	// the only parameter that belongs to the texture, the rest comes from the sampler.
+	// without it a single level array would be incomplete under a mipmapping filter
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levels - 1);
+	GLObjects::Created(GLObjects::TEXTURE, ID, Bytes());
+}
+
+void TextureArray::SetLayer(GLsizei layer, const unsigned char *pixels, GLsizei rowPixels) {
+	GLState::BindTexture(GL_TEXTURE_2D_ARRAY, ID);
+	if (rowPixels != 0 && rowPixels != width) {
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, rowPixels);
+	}
+	glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	if (rowPixels != 0 && rowPixels != width) {
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	}
+}
+
+void TextureArray::GenerateMipmaps() {
+	GLState::BindTexture(GL_TEXTURE_2D_ARRAY, ID);
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+}
+
+size_t TextureArray::Bytes() const {
+	size_t bytes = 0;
+	for (GLint level = 0; level < levels; level++) {
+		size_t levelWidth = width >> level > 0 ? width >> level : 1;
+		size_t levelHeight = height >> level > 0 ? height >> level : 1;
+		bytes += levelWidth * levelHeight * 4 * layers;
+	}
+	return bytes;
+}
+
+void TextureArray::Bind(GLuint unit) {
+	GLState::BindTexture(unit, GL_TEXTURE_2D_ARRAY, ID);
+}
+
+void TextureArray::Delete() {
+	if (ID == 0) {
+		return;
+	}
+	glDeleteTextures(1, &ID);
+	GLState::TextureDeleted(ID);
+	GLObjects::Deleted(GLObjects::TEXTURE, ID);
+	ID = 0;
+	layers = 0;
+}
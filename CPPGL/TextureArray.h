@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// a GL_TEXTURE_2D_ARRAY of same-sized rgba layers, for tiles and sprite sheet
+// frames. a sprite picks its layer through the vertex format, so sprites with
+// different images can still go out in one draw. there's no filtering set on
+// it, bind a sampler from Samplers alongside it. freed when it goes out of
+// scope, moves hand over the ID, copies aren't allowed
+class TextureArray {
+public:
+	GLuint ID;
+	GLsizei width;
+	GLsizei height;
+	// 0 if the files couldn't be loaded
+	GLsizei layers;
+	GLint levels;
+
+	// storage for layers layers, filled in with SetLayer. levels 0 means the full mip chain
+	TextureArray(GLsizei width, GLsizei height, GLsizei layers, GLint levels = 1);
+	// cuts a sprite sheet into tileWidth x tileHeight tiles, one layer each,
+	// left to right then top to bottom
+	TextureArray(const char *sheetFile, GLsizei tileWidth, GLsizei tileHeight, GLint levels = 1);
+	// one layer per file, they all have to be the same size
+	TextureArray(const std::vector<std::string> &files, GLint levels = 1);
+	~TextureArray();
+	TextureArray(TextureArray &&other) noexcept;
+	TextureArray &operator=(TextureArray &&other) noexcept;
+	TextureArray(const TextureArray &) = delete;
+	TextureArray &operator=(const TextureArray &) = delete;
+
+	// width x height rgba pixels into one layer's base level. rowPixels is how
+	// wide the source image is, 0 when it's exactly width, so a tile can be
+	// copied straight out of a bigger sheet
+	void SetLayer(GLsizei layer, const unsigned char *pixels, GLsizei rowPixels = 0);
+	// rebuilds the smaller levels of every layer, after the layers are set
+	void GenerateMipmaps();
+	size_t Bytes() const;
+
+	void Bind(GLuint unit);
+	// frees it early, the destructor does it otherwise
+	void Delete();
+
+private:
+	TextureArray();
+	void allocate(GLsizei width, GLsizei height, GLsizei layers, GLint levels);
+};
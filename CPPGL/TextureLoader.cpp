@@ -0,0 +1,238 @@
+#include "TextureLoader.h"
+#include "Texture.h"
+#include "stb/stb_image.h"
+#include "Timing.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+TextureLoader::TextureLoader(int threads, size_t budget)
+	: uploadBudget(budget), cpuMips(true), stopping(false), decoded(NULL), nextId(1), stats()
+{
+	if (threads <= 0) {
+		threads = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+	}
+	for (int i = 0; i < threads; i++) {
+		workers.emplace_back(&TextureLoader::work, this);
+	}
+}
+
+TextureLoader::~TextureLoader() {
+	{
+		std::lock_guard<std::mutex> lock(requestLock);
+		stopping = true;
+		requests.clear();
+	}
+	requestReady.notify_all();
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+
+	collect();
+	for (Decoded *image : uploads) {
+		release(image);
+	}
+	// whatever is still waiting never gets its pixels, so don't let it call back in
+	for (auto &entry : waiting) {
+		entry.second->loader = NULL;
+	}
+}
+
+unsigned int TextureLoader::Add(Texture *texture, const std::string &file) {
+	unsigned int id = nextId++;
+	waiting[id] = texture;
+	{
+		std::lock_guard<std::mutex> lock(requestLock);
+		requests.push_back({ id, file, cpuMips, mipOptions });
+		stats.peakDecodeQueue = std::max(stats.peakDecodeQueue, requests.size());
+	}
+	requestReady.notify_one();
+	return id;
+}
+
+void TextureLoader::Remove(unsigned int id) {
+	// a worker may still be decoding it, the pixels get dropped when they turn up
+	waiting.erase(id);
+}
+
+void TextureLoader::Replace(unsigned int id, Texture *texture) {
+	auto found = waiting.find(id);
+	if (found != waiting.end()) {
+		found->second = texture;
+	}
+}
+
+void TextureLoader::work() {
+	for (;;) {
+		Request request;
+		{
+			std::unique_lock<std::mutex> lock(requestLock);
+			requestReady.wait(lock, [this]() { return stopping || !requests.empty(); });
+			if (stopping) {
+				return;
+			}
+			request = std::move(requests.front());
+			requests.pop_front();
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		Decoded *image = new Decoded();
+		image->id = request.id;
+		int channels;
+		image->pixels = stbi_load(request.file.c_str(), &image->width, &image->height, &channels, 4);
+		if (image->pixels == NULL) {
+			// stb keeps the failure reason per thread, so this is ours
+			std::cout << "couldn't load texture " << request.file << ": " << stbi_failure_reason() << std::endl;
+		}
+		image->decodeMs = millisecondsSince(start);
+		if (image->pixels != NULL && request.cpuMips) {
+			start = std::chrono::steady_clock::now();
+			image->mips = MipGenerator::Generate(image->pixels, image->width, image->height, request.mipOptions);
+			image->mipMs = millisecondsSince(start);
+		}
+
+		// push onto the front of the list, retrying if another worker got there first
+		image->next = decoded.load(std::memory_order_relaxed);
+		while (!decoded.compare_exchange_weak(image->next, image,
+			std::memory_order_release, std::memory_order_relaxed)) {
+		}
+	}
+}
+
+void TextureLoader::collect() {
+	Decoded *list = decoded.exchange(NULL, std::memory_order_acquire);
+	// the list comes off newest first, flip it so uploads go in decode order
+	Decoded *reversed = NULL;
+	while (list != NULL) {
+		Decoded *next = list->next;
+		list->next = reversed;
+		reversed = list;
+		list = next;
+	}
+	for (Decoded *image = reversed; image != NULL; image = image->next) {
+		uploads.push_back(image);
+		stats.decoded++;
+		stats.decodeMs += image->decodeMs;
+		stats.mipMs += image->mipMs;
+	}
+	stats.peakUploadQueue = std::max(stats.peakUploadQueue, uploads.size());
+}
+
+void TextureLoader::release(Decoded *image) {
+	stbi_image_free(image->pixels);
+	delete image;
+}
+
+bool TextureLoader::Update() {
+	collect();
+	if (uploads.empty()) {
+		return Pending() == 0;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	size_t spent = 0;
+	while (!uploads.empty() && spent < uploadBudget) {
+		Decoded *image = uploads.front();
+		auto found = waiting.find(image->id);
+		if (found == waiting.end() || image->pixels == NULL) {
+			// deleted while it was decoding, or there was nothing to decode
+			if (found != waiting.end()) {
+				found->second->status = Texture::FAILED;
+				found->second->loader = NULL;
+				waiting.erase(found);
+				stats.failed++;
+			}
+			uploads.pop_front();
+			release(image);
+			continue;
+		}
+
+		Texture *texture = found->second;
+		if (image->level == 0 && image->rowsUploaded == 0) {
+			texture->allocate(image->width, image->height);
+			if (!image->mips.empty()) {
+				texture->allocateMips();
+			}
+		}
+		const unsigned char *pixels = image->pixels;
+		int levelWidth = image->width;
+		int levelHeight = image->height;
+		if (image->level > 0) {
+			const MipGenerator::Level &mip = image->mips[image->level - 1];
+			pixels = mip.pixels.data();
+			levelWidth = mip.width;
+			levelHeight = mip.height;
+		}
+		// as many whole rows as the budget has room for, but always at least one
+		size_t rowBytes = (size_t)levelWidth * 4;
+		size_t fits = std::max((size_t)1, (uploadBudget - spent) / rowBytes);
+		int rows = (int)std::min(fits, (size_t)(levelHeight - image->rowsUploaded));
+		texture->uploadRows(image->level, pixels, image->rowsUploaded, rows);
+		image->rowsUploaded += rows;
+		spent += rows * rowBytes;
+
+		if (image->rowsUploaded == levelHeight && image->level < (int)image->mips.size()) {
+			image->level++;
+			image->rowsUploaded = 0;
+		} else if (image->rowsUploaded == levelHeight) {
+			texture->finish(image->mips.empty());
+			texture->loader = NULL;
+			waiting.erase(found);
+			uploads.pop_front();
+			release(image);
+			stats.uploaded++;
+		}
+	}
+
+	double ms = millisecondsSince(start);
+	stats.uploadMs += ms;
+	stats.maxUpdateMs = std::max(stats.maxUpdateMs, ms);
+	stats.bytesUploaded += spent;
+	return Pending() == 0;
+}
+
+void TextureLoader::Wait() {
+	size_t budget = uploadBudget;
+	uploadBudget = (size_t)-1;
+	while (!Update()) {
+		// the rest are still on the workers
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+	uploadBudget = budget;
+}
+
+TextureLoader::Stats TextureLoader::GetStats() const {
+	Stats current = stats;
+	{
+		std::lock_guard<std::mutex> lock(requestLock);
+		current.decodeQueue = requests.size();
+	}
+	current.uploadQueue = uploads.size();
+	return current;
+}
+
+void TextureLoader::ResetStats() {
+	stats = Stats();
+}
+
+void TextureLoader::PrintReport() const {
+	Stats current = GetStats();
+	printf("texture loader: %zu threads, %u decoded, %u uploaded, %u failed, %zu pending\n",
+		workers.size(), current.decoded, current.uploaded, current.failed, Pending());
+	if (current.decoded > 0) {
+		printf("  decode       %.2f ms total, %.2f ms avg (worker time)\n",
+			current.decodeMs, current.decodeMs / current.decoded);
+		if (current.mipMs > 0.0) {
+			printf("  mips         %.2f ms total, %.2f ms avg (worker time, %s)\n",
+				current.mipMs, current.mipMs / current.decoded, MipGenerator::PathName(MipGenerator::Detect()));
+		}
+	}
+	if (current.uploaded > 0) {
+		printf("  upload       %.2f ms total, %.3f ms avg, %.3f ms worst frame, %.2f MB\n",
+			current.uploadMs, current.uploadMs / current.uploaded, current.maxUpdateMs,
+			current.bytesUploaded / (1024.0 * 1024.0));
+	}
+	printf("  queue depth  %zu decoding (peak %zu), %zu to upload (peak %zu)\n",
+		current.decodeQueue, current.peakDecodeQueue, current.uploadQueue, current.peakUploadQueue);
+}
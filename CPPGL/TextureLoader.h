@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "MipGenerator.h"
+
+class Texture;
+
+// loads textures without stalling the frame: worker threads decode the files
+// with stb_image, build their mip chains, and push the pixels onto a lock-free
+// list, and Update (on the GL thread, once per frame) uploads at most
+// uploadBudget bytes of them. a big image can take a few frames, it goes up a
+// strip of rows at a time, level by level
+class TextureLoader {
+public:
+	struct Stats {
+		unsigned int decoded;
+		unsigned int uploaded;
+		unsigned int failed;
+		// decode time is summed over the workers, so it can be more than wall time
+		double decodeMs;
+		// worker time building mip chains, summed the same way
+		double mipMs;
+		double uploadMs;
+		// the most any one Update spent uploading
+		double maxUpdateMs;
+		unsigned long long bytesUploaded;
+		// files waiting for a worker, and decoded images waiting for Update
+		size_t decodeQueue;
+		size_t uploadQueue;
+		size_t peakDecodeQueue;
+		size_t peakUploadQueue;
+	};
+
+	// bytes Update may upload per call, always at least one row
+	size_t uploadBudget;
+	// build each texture's mips on the workers, so the GL thread only uploads
+	// them. off means glGenerateMipmap once the base level is in. both are read
+	// when a texture is added, changing them doesn't affect ones already loading
+	bool cpuMips;
+	MipGenerator::Options mipOptions;
+
+	// threads 0 means one less than the number of cores (at least one)
+	TextureLoader(int threads = 0, size_t uploadBudget = 4 * 1024 * 1024);
+	// textures still loading are left PENDING with nothing more coming
+	~TextureLoader();
+	TextureLoader(const TextureLoader &) = delete;
+	TextureLoader &operator=(const TextureLoader &) = delete;
+
+	// Texture's loader constructor calls these, the id is how the workers refer to it
+	unsigned int Add(Texture *texture, const std::string &file);
+	void Remove(unsigned int id);
+	// a pending Texture was moved, upload into it at its new address
+	void Replace(unsigned int id, Texture *texture);
+
+	// uploads whatever has finished decoding, within the budget. returns true once
+	// nothing is pending
+	bool Update();
+	// blocks until every texture added so far has been uploaded, ignoring the budget
+	void Wait();
+
+	size_t Pending() const { return waiting.size(); }
+	Stats GetStats() const;
+	void ResetStats();
+	void PrintReport() const;
+
+private:
+	struct Request {
+		unsigned int id;
+		std::string file;
+		bool cpuMips;
+		MipGenerator::Options mipOptions;
+	};
+	// filled in by a worker, then owned by the GL thread once it's off the list
+	struct Decoded {
+		unsigned int id;
+		unsigned char *pixels; // NULL if the decode failed
+		int width;
+		int height;
+		// every level below the base, empty if the GL thread is to generate them
+		std::vector<MipGenerator::Level> mips;
+		double decodeMs;
+		double mipMs;
+		// the level going up now, and how far into it
+		int level;
+		int rowsUploaded;
+		Decoded *next;
+	};
+
+	std::vector<std::thread> workers;
+	mutable std::mutex requestLock;
+	std::condition_variable requestReady;
+	std::deque<Request> requests;
+	bool stopping;
+
+	// workers push decoded images here, Update takes the whole list at once,
+	// so there's no lock and no ABA problem with a single consumer
+	std::atomic<Decoded*> decoded;
+
+	// everything below is only touched on the GL thread
+	std::unordered_map<unsigned int, Texture*> waiting;
+	std::deque<Decoded*> uploads;
+	unsigned int nextId;
+	Stats stats;
+
+	void work();
+	// moves finished decodes onto uploads, oldest first
+	void collect();
+	static void release(Decoded *image);
+};
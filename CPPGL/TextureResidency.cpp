@@ -0,0 +1,207 @@
+#include "TextureResidency.h"
+#include "GLExtensions.h"
+#include "GLObjects.h"
+#include "GLState.h"
+#include "TextureLoader.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+TextureResidency::TextureResidency(TextureLoader &textureLoader, size_t bytes, GLsizei smallest)
+	: budget(bytes), minSize(smallest), loader(textureLoader), frame(0), reloadsStarted(0), stats()
+{
+}
+
+TextureResidency::~TextureResidency() {
+	for (Entry &entry : entries) {
+		entry.texture->residency = NULL;
+	}
+}
+
+bool TextureResidency::Manage(Texture &texture, const std::string &file) {
+	if (texture.format != GL_RGBA8) {
+		std::cout << "can't manage texture " << file << ", only rgba8 textures can be reloaded" << std::endl;
+		return false;
+	}
+	if (texture.residency == this) {
+		return true;
+	}
+	if (texture.residency != NULL) {
+		texture.residency->Forget(&texture);
+	}
+	entries.push_front({ &texture, file, frame, 0, nullptr });
+	lookup[&texture] = entries.begin();
+	texture.residency = this;
+	return true;
+}
+
+void TextureResidency::Forget(Texture *texture) {
+	auto found = lookup.find(texture);
+	if (found == lookup.end()) {
+		return;
+	}
+	// a reload still in flight takes itself off the loader as it goes
+	entries.erase(found->second);
+	lookup.erase(found);
+}
+
+void TextureResidency::Replace(Texture *from, Texture *to) {
+	auto found = lookup.find(from);
+	if (found == lookup.end()) {
+		return;
+	}
+	std::list<Entry>::iterator entry = found->second;
+	entry->texture = to;
+	lookup.erase(found);
+	lookup[to] = entry;
+}
+
+void TextureResidency::Use(Texture &texture) {
+	auto found = lookup.find(&texture);
+	if (found == lookup.end()) {
+		return;
+	}
+	std::list<Entry>::iterator entry = found->second;
+	entry->lastFrame = frame;
+	entries.splice(entries.begin(), entries, entry);
+	if (entry->dropped > 0 && entry->reload == nullptr && !entry->file.empty()) {
+		entry->reload.reset(new Texture(entry->file.c_str(), loader, texture.filter, texture.wrap));
+		reloadsStarted++;
+		stats.totalReloads++;
+	}
+}
+
+void TextureResidency::Update() {
+	stats.evictions = 0;
+	stats.reloads = reloadsStarted;
+	reloadsStarted = 0;
+
+	for (Entry &entry : entries) {
+		if (entry.reload != nullptr) {
+			finishReload(entry);
+		}
+	}
+
+	// one level off each unused texture per pass, oldest first, so everything
+	// that's gone cold gets blurrier together rather than the oldest vanishing
+	bool dropped = true;
+	while (resident() > budget && dropped) {
+		dropped = false;
+		for (auto entry = entries.rbegin(); entry != entries.rend() && resident() > budget; ++entry) {
+			if (entry->lastFrame == frame) {
+				// everything from here on was used this frame too
+				break;
+			}
+			if (dropTopLevel(*entry)) {
+				dropped = true;
+				stats.evictions++;
+				stats.totalEvictions++;
+			}
+		}
+	}
+	if (resident() > budget) {
+		stats.peakOverBudget = std::max(stats.peakOverBudget, resident() - budget);
+	}
+	frame++;
+}
+
+size_t TextureResidency::resident() const {
+	return GLObjects::Bytes(GLObjects::TEXTURE) + GLObjects::Bytes(GLObjects::BUFFER);
+}
+
+bool TextureResidency::finishReload(Entry &entry) {
+	Texture &reload = *entry.reload;
+	if (reload.status == Texture::PENDING) {
+		return false;
+	}
+	if (reload.status == Texture::FAILED) {
+		// it's been said why, keep the smaller one and stop asking
+		entry.file.clear();
+		entry.reload.reset();
+		return true;
+	}
+	Texture &texture = *entry.texture;
+	texture.swapStorage(reload);
+	// the swap brings the reload's parameters along, so set all four back to the texture's
+	GLState::BindTexture(GL_TEXTURE_2D, texture.ID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture.filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texture.filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texture.wrap);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texture.wrap);
+	entry.dropped = 0;
+	// frees the reduced storage it was swapped for
+	entry.reload.reset();
+	return true;
+}
+
+bool TextureResidency::dropTopLevel(Entry &entry) {
+	Texture &texture = *entry.texture;
+	if (texture.status != Texture::READY || texture.ID == 0 || texture.levels < 2 ||
+		std::max(texture.width, texture.height) / 2 < minSize) {
+		return false;
+	}
+	if (entry.reload != nullptr) {
+		// it's been used again since, dropping it now would only make the swap drop more
+		return false;
+	}
+
+	// sampled the same way as before, from what it was created with rather than asking GL
+	GLsizei smallWidth = texture.width > 1 ? texture.width / 2 : 1;
+	GLsizei smallHeight = texture.height > 1 ? texture.height / 2 : 1;
+	Texture smaller(smallWidth, smallHeight, texture.filter, texture.wrap, texture.levels - 1);
+
+	std::vector<unsigned char> pixels;
+	for (GLint level = 0; level < smaller.levels; level++) {
+		GLsizei levelWidth = smallWidth >> level > 0 ? smallWidth >> level : 1;
+		GLsizei levelHeight = smallHeight >> level > 0 ? smallHeight >> level : 1;
+		if (GLExtensions::ARB_copy_image) {
+			// GPU to GPU, nothing comes back to the cpu
+			glCopyImageSubData(texture.ID, GL_TEXTURE_2D, level + 1, 0, 0, 0,
+				smaller.ID, GL_TEXTURE_2D, level, 0, 0, 0, levelWidth, levelHeight, 1);
+		} else {
+			pixels.resize((size_t)levelWidth * levelHeight * 4);
+			GLState::BindTexture(GL_TEXTURE_2D, texture.ID);
+			glGetTexImage(GL_TEXTURE_2D, level + 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+			smaller.uploadRows(level, pixels.data(), 0, levelHeight);
+		}
+	}
+
+	// smaller goes out of scope with the old storage
+	texture.swapStorage(smaller);
+	entry.dropped++;
+	return true;
+}
+
+TextureResidency::Stats TextureResidency::GetStats() const {
+	Stats current = stats;
+	current.textureBytes = GLObjects::Bytes(GLObjects::TEXTURE);
+	current.bufferBytes = GLObjects::Bytes(GLObjects::BUFFER);
+	current.budget = budget;
+	current.managed = entries.size();
+	current.reduced = 0;
+	for (const Entry &entry : entries) {
+		if (entry.dropped > 0) {
+			current.reduced++;
+		}
+	}
+	return current;
+}
+
+void TextureResidency::ResetStats() {
+	stats = Stats();
+	reloadsStarted = 0;
+}
+
+void TextureResidency::PrintReport() const {
+	Stats current = GetStats();
+	const double mb = 1024.0 * 1024.0;
+	printf("residency: %.2f MB textures + %.2f MB buffers of %.2f MB, %zu managed (%zu reduced), "
+		"%u levels dropped, %u reloads started, %llu evictions, %llu reloads total",
+		current.textureBytes / mb, current.bufferBytes / mb, current.budget / mb, current.managed, current.reduced,
+		current.evictions, current.reloads, current.totalEvictions, current.totalReloads);
+	if (current.peakOverBudget > 0) {
+		printf(", up to %.2f MB over", current.peakOverBudget / mb);
+	}
+	printf("\n");
+}
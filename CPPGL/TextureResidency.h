@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "Texture.h"
+
+class TextureLoader;
+
+// keeps what's on the GPU under a budget. every texture and buffer is counted
+// (through GLObjects), and when the total goes over, the managed textures that
+// haven't been used for longest lose their largest mip level, one level at a
+// time, until it fits again. a reduced texture still draws, just blurrier, and
+// using it again reloads the full image from its file through a TextureLoader.
+// call Use for each managed texture drawn and Update once per frame, all on the
+// GL thread
+class TextureResidency {
+public:
+	struct Stats {
+		// what's resident right now, managed or not
+		size_t textureBytes;
+		size_t bufferBytes;
+		size_t budget;
+		size_t managed;
+		// managed textures missing at least their top level
+		size_t reduced;
+		// levels dropped in the last Update, and full reloads started in the
+		// frame before it
+		unsigned int evictions;
+		unsigned int reloads;
+		// the same since the last ResetStats
+		unsigned long long totalEvictions;
+		unsigned long long totalReloads;
+		// the most it's been over budget after an Update, when everything left
+		// was in use or already as small as it goes
+		size_t peakOverBudget;
+	};
+
+	// bytes of textures plus buffers to stay under
+	size_t budget;
+	// textures are never reduced below this many pixels on their longer side
+	GLsizei minSize;
+
+	TextureResidency(TextureLoader &loader, size_t budget, GLsizei minSize = 16);
+	// textures still managed are left at whatever size they are
+	~TextureResidency();
+	TextureResidency(const TextureResidency &) = delete;
+	TextureResidency &operator=(const TextureResidency &) = delete;
+
+	// starts managing a loaded rgba8 texture, file is what to reload it from.
+	// false (and it's left alone) if it isn't rgba8
+	bool Manage(Texture &texture, const std::string &file);
+	// Texture's destructor and move call these
+	void Forget(Texture *texture);
+	void Replace(Texture *from, Texture *to);
+
+	// marks it used this frame. a reduced texture starts reloading
+	void Use(Texture &texture);
+	// finishes reloads that are in, and evicts until it's under budget again.
+	// textures used since the last Update are never evicted
+	void Update();
+
+	size_t Managed() const { return entries.size(); }
+	Stats GetStats() const;
+	void ResetStats();
+	// one line for the last Update, with the totals
+	void PrintReport() const;
+
+private:
+	struct Entry {
+		Texture *texture;
+		std::string file;
+		unsigned long long lastFrame;
+		// top levels dropped so far
+		int dropped;
+		// the full image coming back in, swapped in once it's ready
+		std::unique_ptr<Texture> reload;
+	};
+
+	TextureLoader &loader;
+	// most recently used first
+	std::list<Entry> entries;
+	std::unordered_map<Texture*, std::list<Entry>::iterator> lookup;
+	unsigned long long frame;
+	// Use starts reloads between Updates, they're counted for the Update after
+	unsigned int reloadsStarted;
+	Stats stats;
+
+	size_t resident() const;
+	// swaps in a finished reload, returns false if it's still loading
+	bool finishReload(Entry &entry);
+	// replaces the texture with one half the size holding its levels 1..n
+	bool dropTopLevel(Entry &entry);
+};
@@ -0,0 +1,64 @@
+#include "TextureUploader.h"
+#include "GLState.h"
+#include <cstring>
+#include <iostream>
+
+TextureUploader::TextureUploader(GLsizeiptr regionSize, int regions)
+	: stream(GL_PIXEL_UNPACK_BUFFER, regionSize, regions), stats()
+{
+	// glTexImage2D everywhere else reads client memory, which only works while
+	// no unpack buffer is bound
+	GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void TextureUploader::Upload(Texture &texture, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+	const unsigned char *pixels, GLsizei sourceStride) {
+	GLsizeiptr rowBytes = (GLsizeiptr)width * 4;
+	if (sourceStride == 0) {
+		sourceStride = (GLsizei)rowBytes;
+	}
+	GLsizei stripRows = (GLsizei)(stream.RegionSize() / rowBytes);
+	if (stripRows == 0) {
+		std::cout << "texture upload rows of " << rowBytes << " bytes don't fit a "
+			<< stream.RegionSize() << " byte staging region" << std::endl;
+		return;
+	}
+
+	GLState::BindTexture(GL_TEXTURE_2D, texture.ID);
+	for (GLsizei row = 0; row < height; row += stripRows) {
+		GLsizei rows = height - row < stripRows ? height - row : stripRows;
+		GLintptr offset = 0;
+		unsigned char *staging = (unsigned char*)stream.Map(rows * rowBytes, offset);
+		if (staging == NULL) {
+			std::cout << "couldn't map " << rows * rowBytes << " bytes of texture staging" << std::endl;
+			break;
+		}
+		const unsigned char *source = pixels + (size_t)row * sourceStride;
+		if (sourceStride == rowBytes) {
+			memcpy(staging, source, rows * rowBytes);
+		} else {
+			// pack the rows tightly on the way in, so GL never needs UNPACK_ROW_LENGTH
+			for (GLsizei i = 0; i < rows; i++) {
+				memcpy(staging + i * rowBytes, source + (size_t)i * sourceStride, rowBytes);
+			}
+		}
+		stream.Unmap();
+
+		// with an unpack buffer bound the pointer argument is an offset into it
+		stream.Bind();
+		glTexSubImage2D(GL_TEXTURE_2D, level, x, y + row, width, rows, GL_RGBA, GL_UNSIGNED_BYTE, (void*)offset);
+		stats.strips++;
+	}
+	GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	stats.uploads++;
+	stats.bytes += (unsigned long long)rowBytes * height;
+}
+
+void TextureUploader::EndFrame() {
+	stream.EndFrame();
+}
+
+void TextureUploader::ResetStats() {
+	stats = Stats();
+	stream.ResetStats();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "StreamBuffer.h"
+#include "Texture.h"
+
+// uploads texture pixels through pixel unpack buffers instead of straight from
+// client memory. the pixels get copied into a StreamBuffer on GL_PIXEL_UNPACK_BUFFER
+// and glTexSubImage2D reads them from there, so the call returns right away and
+// the driver moves the data on its own time. the stream's regions are the
+// staging pool, each one fenced at EndFrame and only written again once the GPU
+// has finished with it
+class TextureUploader {
+public:
+	struct Stats {
+		unsigned int uploads;
+		// glTexSubImage2D calls, an upload bigger than a region is split into strips of rows
+		unsigned int strips;
+		unsigned long long bytes;
+	};
+
+	StreamBuffer stream;
+
+	// regionSize is the most one frame can stage before it has to wait on an older region
+	TextureUploader(GLsizeiptr regionSize = 4 * 1024 * 1024, int regions = 3);
+
+	// copies a width x height rgba rectangle into level of texture with its corner
+	// at x, y. sourceStride is the bytes between rows of pixels, 0 when they're
+	// tightly packed, so a rectangle can come straight out of a bigger image
+	void Upload(Texture &texture, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+		const unsigned char *pixels, GLsizei sourceStride = 0);
+	// fences this frame's staging region, once per frame after the uploads
+	void EndFrame();
+
+	Stats GetStats() const { return stats; }
+	void ResetStats();
+
+private:
+	Stats stats;
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <chrono>
+
+// milliseconds on the steady clock since start, which is how every load time,
+// stall and bench step gets reported
+inline double millisecondsSince(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,11 @@
+#include "UBO.h"
+#include "GLState.h"
+
+UBO::UBO(const void *data, GLsizeiptr size, GLenum usage)
+	: BufferObject(GL_UNIFORM_BUFFER, data, size, usage)
+{
+}
+
+void UBO::BindBase(GLuint index) {
+	GLState::BindBufferBase(GL_UNIFORM_BUFFER, index, ID);
+}
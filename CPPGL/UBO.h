@@ -0,0 +1,15 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "BufferObject.h"
+
+// a uniform buffer for data that changes at most once a frame, like the Frame
+// block. per-draw data goes through a UniformRing instead
+class UBO : public BufferObject {
+public:
+	UBO(const void *data, GLsizeiptr size, GLenum usage = GL_DYNAMIC_DRAW);
+
+	// the whole buffer on binding point index, where every program's block
+	// registered on that binding reads it from
+	void BindBase(GLuint index);
+};
@@ -0,0 +1,47 @@
+#include "UniformBlocks.h"
+#include <iostream>
+#include <vector>
+
+namespace {
+	struct Entry {
+		std::string name;
+		GLuint binding;
+		GLsizeiptr size;
+	};
+	// a handful of blocks at most, a flat list beats hashing
+	std::vector<Entry> blocks = {
+		{ "Frame", UniformBlocks::FRAME, sizeof(UniformBlocks::FrameBlock) },
+		{ "Object", UniformBlocks::OBJECT, sizeof(UniformBlocks::ObjectBlock) }
+	};
+}
+
+void UniformBlocks::Register(const std::string &name, GLuint binding, GLsizeiptr size) {
+	for (Entry &entry : blocks) {
+		if (entry.name == name) {
+			if (entry.binding != binding || entry.size != size) {
+				std::cout << "uniform block " << name << " registered again with a different binding or size" << std::endl;
+			}
+			entry.binding = binding;
+			entry.size = size;
+			return;
+		}
+	}
+	blocks.push_back({ name, binding, size });
+}
+
+bool UniformBlocks::Find(const std::string &name, GLuint &binding, GLsizeiptr &size) {
+	for (const Entry &entry : blocks) {
+		if (entry.name == name) {
+			binding = entry.binding;
+			size = entry.size;
+			return true;
+		}
+	}
+	return false;
+}
+
+std140::mat4 UniformBlocks::Identity() {
+	std140::mat4 identity = {};
+	identity.m[0] = identity.m[5] = identity.m[10] = identity.m[15] = 1.0f;
+	return identity;
+}
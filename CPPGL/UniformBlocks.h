@@ -0,0 +1,59 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include "Std140.h"
+
+// the uniform blocks every shader can use, and which binding point each one
+// lives on. uniform_blocks.glsl declares the GLSL side, #include it to get them.
+// GLSL 330 can't say layout(binding = N), so a Shader looks its blocks up here
+// once it's linked and points them at the right binding with glUniformBlockBinding.
+// a buffer bound to a binding point stays there across glUseProgram, which is
+// the point: per-frame data is uploaded and bound once, not set on every program
+namespace UniformBlocks {
+	enum Binding {
+		// one shared UBO for the whole frame
+		FRAME = 0,
+		// a slice of a UniformRing per draw
+		OBJECT = 1,
+		// Register more from here up
+		FIRST_FREE = 2
+	};
+
+	// layout(std140) uniform Frame in uniform_blocks.glsl
+	struct FrameBlock {
+		std140::mat4 viewProjection;
+		// in pixels
+		std140::vec2 viewport;
+		// seconds since the start
+		GLfloat time;
+		// how much bigger than its vertices default.vert draws the quad
+		GLfloat scale;
+	};
+	STD140_OFFSET(FrameBlock, viewProjection, 0);
+	STD140_OFFSET(FrameBlock, viewport, 64);
+	STD140_OFFSET(FrameBlock, time, 72);
+	STD140_OFFSET(FrameBlock, scale, 76);
+	STD140_SIZE(FrameBlock, 80);
+
+	// layout(std140) uniform Object in uniform_blocks.glsl
+	struct ObjectBlock {
+		std140::mat4 transform;
+		std140::vec4 tint;
+		// min uv in xy, max in zw
+		std140::vec4 uvRect;
+	};
+	STD140_OFFSET(ObjectBlock, transform, 0);
+	STD140_OFFSET(ObjectBlock, tint, 64);
+	STD140_OFFSET(ObjectBlock, uvRect, 80);
+	STD140_SIZE(ObjectBlock, 96);
+
+	// a block name that should always land on binding, and how big its C++
+	// mirror is. Frame and Object are already there
+	void Register(const std::string &name, GLuint binding, GLsizeiptr size);
+	// the binding for a block, false if nobody registered it
+	bool Find(const std::string &name, GLuint &binding, GLsizeiptr &size);
+
+	// the identity matrix, for blocks that don't need a camera yet
+	std140::mat4 Identity();
+}
@@ -0,0 +1,33 @@
+#include "UniformRing.h"
+#include "GLState.h"
+#include <cstring>
+#include <iostream>
+
+static GLsizeiptr uniformAlignment() {
+	GLint alignment = 256;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	return alignment > 0 ? alignment : 256;
+}
+
+UniformRing::UniformRing(GLsizeiptr regionSize, int regions)
+	: stream(GL_UNIFORM_BUFFER, regionSize, regions), alignment(uniformAlignment())
+{
+}
+
+bool UniformRing::Push(GLuint index, const void *data, GLsizeiptr size) {
+	GLintptr offset = 0;
+	void *slice = stream.Map(size, offset, alignment);
+	if (slice == NULL) {
+		std::cout << "a " << size << " byte uniform block doesn't fit a " << stream.RegionSize()
+			<< " byte ring region" << std::endl;
+		return false;
+	}
+	memcpy(slice, data, size);
+	stream.Unmap();
+	GLState::BindBufferRange(GL_UNIFORM_BUFFER, index, stream.vbo.ID, offset, size);
+	return true;
+}
+
+void UniformRing::EndFrame() {
+	stream.EndFrame();
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "StreamBuffer.h"
+
+// per-draw uniform blocks carved out of one big StreamBuffer: each Push copies
+// a block into the current frame's region at the next offset the driver allows
+// and binds just that slice with glBindBufferRange. no buffer is made or
+// orphaned per draw, and the fences keep the GPU's slices from being overwritten
+class UniformRing {
+public:
+	StreamBuffer stream;
+
+	// regionSize is one frame's worth of blocks, each rounded up to Alignment()
+	UniformRing(GLsizeiptr regionSize, int regions = 3);
+
+	// copies size bytes into the ring and binds them to binding point index.
+	// false (and nothing bound) if they're bigger than a whole region
+	bool Push(GLuint index, const void *data, GLsizeiptr size);
+	template<typename Block>
+	bool Push(GLuint index, const Block &block) {
+		return Push(index, &block, sizeof(Block));
+	}
+	// once per frame, after its draws
+	void EndFrame();
+
+	// GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, every slice starts on a multiple of it
+	GLsizeiptr Alignment() const { return alignment; }
+
+private:
+	GLsizeiptr alignment;
+};
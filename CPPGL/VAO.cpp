@@ -1,7 +1,31 @@
 #include "VAO.h"
+#include "GLObjects.h"
+#include "GLState.h"
+#include "shaderClass.h"
+#include <iostream>
 
 VAO::VAO() {
 	glGenVertexArrays(1, &ID);
+	GLState::VertexArrayCreated(ID);
+	GLObjects::Created(GLObjects::VERTEX_ARRAY, ID, 0);
+}
+
+VAO::~VAO() {
+	Delete();
+}
+
+VAO::VAO(VAO &&other) noexcept : ID(other.ID), linked(std::move(other.linked)) {
+	other.ID = 0;
+}
+
+VAO &VAO::operator=(VAO &&other) noexcept {
+	if (this != &other) {
+		Delete();
+		ID = other.ID;
+		linked = std::move(other.linked);
+		other.ID = 0;
+	}
+	return *this;
 }
 
 void VAO::LinkAttrib(
@@ -10,22 +34,144 @@ void VAO::LinkAttrib(
 	GLuint numComponents, // components per vector (it's three floats remember)
 	GLenum type,
 	GLsizeiptr stride,
-	void *offset
+	void *offset,
+	GLboolean normalized
 	) {
+	// the attribute remembers which buffer was bound when it was linked, so the
+	// VBO can stay bound across calls and the caller unbinds it once at the end
 	vbo.Bind();
-	glVertexAttribPointer(layout, numComponents, type, GL_FALSE, stride, offset);
+	glVertexAttribPointer(layout, numComponents, type, normalized, stride, offset);
 	glEnableVertexAttribArray(layout);
-	vbo.Unbind();
+	if (layout >= linked.size()) {
+		linked.resize(layout + 1, Linked{ 0, 0 });
+	}
+	linked[layout] = { (GLint)numComponents, type };
+}
+
+void VAO::LinkInstanceAttrib(
+	VBO &vbo,
+	GLuint layout,
+	GLuint numComponents,
+	GLenum type,
+	GLsizeiptr stride,
+	void *offset,
+	GLuint divisor,
+	GLboolean normalized
+	) {
+	LinkAttrib(vbo, layout, numComponents, type, stride, offset, normalized);
+	glVertexAttribDivisor(layout, divisor);
+}
+
+void VAO::LinkMatrixAttrib(
+	VBO &vbo,
+	GLuint layout,
+	GLuint columns,
+	GLuint rows,
+	GLsizeiptr stride,
+	void *offset,
+	GLuint divisor
+	) {
+	for (GLuint column = 0; column < columns; column++) {
+		void *columnOffset = (char*)offset + column * rows * sizeof(GLfloat);
+		LinkInstanceAttrib(vbo, layout + column, rows, GL_FLOAT, stride, columnOffset, divisor);
+	}
+}
+
+// how many locations an attribute type takes and how many components each one
+// reads. false for types we don't check, like doubles
+static bool attributeShape(GLenum type, GLint &components, GLint &columns, bool &integer) {
+	columns = 1;
+	integer = false;
+	switch (type) {
+	case GL_FLOAT: components = 1; return true;
+	case GL_FLOAT_VEC2: components = 2; return true;
+	case GL_FLOAT_VEC3: components = 3; return true;
+	case GL_FLOAT_VEC4: components = 4; return true;
+	case GL_FLOAT_MAT2: components = 2; columns = 2; return true;
+	case GL_FLOAT_MAT3: components = 3; columns = 3; return true;
+	case GL_FLOAT_MAT4: components = 4; columns = 4; return true;
+	case GL_FLOAT_MAT2x3: components = 3; columns = 2; return true;
+	case GL_FLOAT_MAT2x4: components = 4; columns = 2; return true;
+	case GL_FLOAT_MAT3x2: components = 2; columns = 3; return true;
+	case GL_FLOAT_MAT3x4: components = 4; columns = 3; return true;
+	case GL_FLOAT_MAT4x2: components = 2; columns = 4; return true;
+	case GL_FLOAT_MAT4x3: components = 3; columns = 4; return true;
+	}
+	integer = true;
+	switch (type) {
+	case GL_INT: case GL_UNSIGNED_INT: components = 1; return true;
+	case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: components = 2; return true;
+	case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: components = 3; return true;
+	case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: components = 4; return true;
+	}
+	return false;
+}
+
+bool VAO::Link(const Shader &shader, VBO &vbo, const VertexLayout &layout) {
+	if (!shader.Ready()) {
+		std::cout << "can't link VAO " << ID << " against shader " << shader.ID
+			<< " before it's ready, it has no locations yet" << std::endl;
+		return false;
+	}
+	Bind();
+	for (const VertexAttribute &attribute : layout.attributes) {
+		const AttributeInfo *input = shader.Attribute(attribute.name);
+		// unused inputs get optimized out, so this isn't always a typo
+		if (input == NULL) {
+			continue;
+		}
+		LinkAttrib(vbo, input->location, attribute.components, attribute.type, layout.stride,
+			(void*)attribute.offset, attribute.normalized);
+	}
+	return Validate(shader);
+}
+
+bool VAO::Validate(const Shader &shader) const {
+	bool ok = true;
+	for (const AttributeInfo &input : shader.Attributes()) {
+		GLint components, columns;
+		bool integer;
+		if (!attributeShape(input.type, components, columns, integer)) {
+			continue;
+		}
+		const std::string &name = Names::Lookup(input.name);
+		for (GLint i = 0; i < columns * input.size; i++) {
+			GLuint location = input.location + i;
+			if (location >= linked.size() || linked[location].components == 0) {
+				std::cout << "shader " << shader.ID << " reads " << name << " at location " << location
+					<< " but VAO " << ID << " has nothing linked there, it would get a constant" << std::endl;
+				ok = false;
+			} else if (integer) {
+				// LinkAttrib goes through glVertexAttribPointer, which hands the shader floats
+				std::cout << "shader " << shader.ID << " reads " << name << " as an integer but VAO " << ID
+					<< " links location " << location << " as floats" << std::endl;
+				ok = false;
+			} else if (linked[location].components > components && linked[location].type == GL_FLOAT) {
+				// legal, but the extra components are fetched for nothing. packed types
+				// like normalized bytes or 10_10_10_2 are padded to four on purpose
+				std::cout << "shader " << shader.ID << " only reads " << components << " of the "
+					<< linked[location].components << " components VAO " << ID << " links for " << name << std::endl;
+			}
+		}
+	}
+	return ok;
 }
 
 void VAO::Bind() {
-	glBindVertexArray(ID);
+	GLState::BindVertexArray(ID);
 }
 
 void VAO::Unbind() {
-	glBindVertexArray(0);
+	GLState::BindVertexArray(0);
 }
 
 void VAO::Delete() {
+	if (ID == 0) {
+		return;
+	}
 	glDeleteVertexArrays(1, &ID);
+	GLState::VertexArrayDeleted(ID);
+	linked.clear();
+	GLObjects::Deleted(GLObjects::VERTEX_ARRAY, ID);
+	ID = 0;
 }
\ No newline at end of file
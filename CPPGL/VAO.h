@@ -2,12 +2,22 @@
 
 
 #include<glad/glad.h>
+#include<vector>
 #include"VBO.h"
+#include"VertexLayout.h"
 
+class Shader;
+
+// deleted when it goes out of scope, moves hand over the ID and copies aren't allowed
 class VAO {
 public:
 	GLuint ID;
 	VAO();
+	~VAO();
+	VAO(VAO &&other) noexcept;
+	VAO &operator=(VAO &&other) noexcept;
+	VAO(const VAO &) = delete;
+	VAO &operator=(const VAO &) = delete;
 
 	// link vertex buffer to vertex array
 	void LinkAttrib(
@@ -16,9 +26,53 @@ public:
 		GLuint numComponents,
 		GLenum type,
 		GLsizeiptr stride,
-		void *offset
+		void *offset,
+		// integer types only: map them to 0..1 (or -1..1) floats in the shader
+		GLboolean normalized = GL_FALSE
+	);
+	// same as LinkAttrib, but the attribute steps once every divisor instances
+	// instead of once per vertex
+	void LinkInstanceAttrib(
+		VBO &vbo,
+		GLuint layout,
+		GLuint numComponents,
+		GLenum type,
+		GLsizeiptr stride,
+		void *offset,
+		GLuint divisor = 1,
+		GLboolean normalized = GL_FALSE
 	);
+	// float matrix attribute, one location per column starting at layout
+	// (a mat4 uses layout to layout + 3), columns packed one after another
+	void LinkMatrixAttrib(
+		VBO &vbo,
+		GLuint layout,
+		GLuint columns,
+		GLuint rows,
+		GLsizeiptr stride,
+		void *offset,
+		GLuint divisor = 1
+	);
+	// links each attribute of layout at the location shader gave it, found by
+	// name, then Validates. attributes the shader doesn't read are skipped. the
+	// shader has to be READY, its locations come from its reflection
+	bool Link(const Shader &shader, VBO &vbo, const VertexLayout &layout);
+	// checks every input the shader reads has something linked at its location
+	// that it can read, printing what doesn't. run it once the shader is READY,
+	// at load time, rather than finding out from a black frame
+	bool Validate(const Shader &shader) const;
+
 	void Bind();
 	void Unbind();
+	// frees it early, the destructor does it otherwise
 	void Delete();
+
+private:
+	// what's been linked at each location, for Validate
+	struct Linked {
+		GLint components;
+		GLenum type;
+	};
+	// indexed by location, components 0 where nothing is linked
+	std::vector<Linked> linked;
 };
\ No newline at end of file
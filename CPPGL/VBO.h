@@ -1,13 +1,11 @@
 #pragma once
 
 #include <glad/glad.h>
+#include "BufferObject.h"
 
-class VBO {
+class VBO : public BufferObject {
 public:
-	GLuint ID;
-	VBO(GLfloat *vertices, GLsizeiptr size);
-
-	void Bind();
-	void Unbind();
-	void Delete();
+	// usage is a hint for the driver: GL_STATIC_DRAW for data set once,
+	// GL_DYNAMIC_DRAW for data patched with Update, GL_STREAM_DRAW for every frame
+	VBO(const void *vertices, GLsizeiptr size, GLenum usage = GL_STATIC_DRAW);
 };
\ No newline at end of file
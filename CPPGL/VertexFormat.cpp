@@ -0,0 +1,65 @@
+#include "VertexFormat.h"
+#include <cstring>
+
+GLushort ToHalf(float value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	GLushort sign = (GLushort)((bits >> 16) & 0x8000);
+	int exponent = (int)((bits >> 23) & 0xFF) - 127 + 15;
+	uint32_t mantissa = bits & 0x7FFFFF;
+	if (exponent >= 31) {
+		// too big, or already inf/nan
+		bool nan = ((bits >> 23) & 0xFF) == 0xFF && mantissa != 0;
+		return (GLushort)(sign | 0x7C00 | (nan ? 0x200 : 0));
+	}
+	if (exponent <= 0) {
+		if (exponent < -10) {
+			return sign;
+		}
+		// subnormal half, shift the implicit 1 in and round
+		mantissa |= 0x800000;
+		int shift = 14 - exponent;
+		uint32_t half = mantissa >> shift;
+		uint32_t rest = mantissa & ((1u << shift) - 1);
+		uint32_t middle = 1u << (shift - 1);
+		if (rest > middle || (rest == middle && (half & 1))) {
+			half++;
+		}
+		return (GLushort)(sign | half);
+	}
+	// round to nearest even, a carry out of the mantissa bumps the exponent, which is right
+	uint32_t half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+	uint32_t rest = mantissa & 0x1FFF;
+	if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) {
+		half++;
+	}
+	return (GLushort)(sign | half);
+}
+
+float FromHalf(GLushort half) {
+	uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+	int exponent = (half >> 10) & 0x1F;
+	uint32_t mantissa = half & 0x3FF;
+	uint32_t bits;
+	if (exponent == 0) {
+		if (mantissa == 0) {
+			bits = sign;
+		} else {
+			// subnormal, normalize it for the float
+			exponent = 1;
+			while ((mantissa & 0x400) == 0) {
+				mantissa <<= 1;
+				exponent--;
+			}
+			mantissa &= 0x3FF;
+			bits = sign | ((uint32_t)(exponent - 15 + 127) << 23) | (mantissa << 13);
+		}
+	} else if (exponent == 31) {
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	} else {
+		bits = sign | ((uint32_t)(exponent - 15 + 127) << 23) | (mantissa << 13);
+	}
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "VAO.h"
+#include "VBO.h"
+#include "VertexLayout.h"
+
+// vertex attributes as types, each one its own storage plus everything
+// glVertexAttribPointer needs to read it. put them in a VertexFormat and the
+// stride, offsets and attribute setup all come out of the compiler instead of
+// 8*sizeof(float) by hand. locations follow the shaders' convention, the names
+// are for VAO::Link to match them up by reflection instead
+struct Position3f {
+	GLfloat x, y, z;
+	static constexpr GLint components = 3;
+	static constexpr GLenum type = GL_FLOAT;
+	static constexpr GLboolean normalized = GL_FALSE;
+	static constexpr GLuint location = 0;
+	static constexpr const char *name = "aPos";
+};
+
+struct Position2f {
+	GLfloat x, y;
+	static constexpr GLint components = 2;
+	static constexpr GLenum type = GL_FLOAT;
+	static constexpr GLboolean normalized = GL_FALSE;
+	static constexpr GLuint location = 0;
+	static constexpr const char *name = "aPos";
+};
+
+// 0..65535 read as 0..1, for positions quantized across a bounding box (see
+// VertexQuantizer). padded to 8 bytes so the attributes after it stay 4 byte aligned
+struct Position3us {
+	GLushort x, y, z, pad;
+	static constexpr GLint components = 3;
+	static constexpr GLenum type = GL_UNSIGNED_SHORT;
+	static constexpr GLboolean normalized = GL_TRUE;
+	static constexpr GLuint location = 0;
+	static constexpr const char *name = "aPos";
+};
+
+struct Color3f {
+	GLfloat r, g, b;
+	static constexpr GLint components = 3;
+	static constexpr GLenum type = GL_FLOAT;
+	static constexpr GLboolean normalized = GL_FALSE;
+	static constexpr GLuint location = 1;
+	static constexpr const char *name = "aCol";
+};
+
+// 0..255 read as 0..1, a quarter of the size of four floats
+struct Color4ub {
+	GLubyte r, g, b, a;
+	static constexpr GLint components = 4;
+	static constexpr GLenum type = GL_UNSIGNED_BYTE;
+	static constexpr GLboolean normalized = GL_TRUE;
+	static constexpr GLuint location = 1;
+	static constexpr const char *name = "aCol";
+
+	static Color4ub Pack(float r, float g, float b, float a = 1.0f);
+};
+
+struct UV2f {
+	GLfloat u, v;
+	static constexpr GLint components = 2;
+	static constexpr GLenum type = GL_FLOAT;
+	static constexpr GLboolean normalized = GL_FALSE;
+	static constexpr GLuint location = 2;
+	static constexpr const char *name = "aTex";
+};
+
+// half floats: 11 bits of precision, exact for texel centers up to 2048 wide
+struct UV2h {
+	GLushort u, v;
+	static constexpr GLint components = 2;
+	static constexpr GLenum type = GL_HALF_FLOAT;
+	static constexpr GLboolean normalized = GL_FALSE;
+	static constexpr GLuint location = 2;
+	static constexpr const char *name = "aTex";
+
+	static UV2h Pack(float u, float v);
+};
+
+struct Normal3f {
+	GLfloat x, y, z;
+	static constexpr GLint components = 3;
+	static constexpr GLenum type = GL_FLOAT;
+	static constexpr GLboolean normalized = GL_FALSE;
+	static constexpr GLuint location = 3;
+	static constexpr const char *name = "aNormal";
+};
+
+// x, y and z in 10 signed bits each and 2 left over, read back as -1..1.
+// GL wants all four components for this type, the shader can still take a vec3
+struct Normal10_10_10_2 {
+	GLuint packed;
+	static constexpr GLint components = 4;
+	static constexpr GLenum type = GL_INT_2_10_10_10_REV;
+	static constexpr GLboolean normalized = GL_TRUE;
+	static constexpr GLuint location = 3;
+	static constexpr const char *name = "aNormal";
+
+	static Normal10_10_10_2 Pack(float x, float y, float z, float w = 0.0f);
+};
+
+// a unit normal folded onto an octahedron and flattened to two -1..1 values,
+// 16 bits each. the shader reads a vec2 and unfolds it, see VertexQuantizer
+struct NormalOct16 {
+	GLshort x, y;
+	static constexpr GLint components = 2;
+	static constexpr GLenum type = GL_SHORT;
+	static constexpr GLboolean normalized = GL_TRUE;
+	static constexpr GLuint location = 3;
+	static constexpr const char *name = "aNormal";
+};
+
+// float to the nearest half, with overflow going to infinity and tiny values
+// to zero, which is all vertex data needs
+GLushort ToHalf(float value);
+float FromHalf(GLushort half);
+
+inline Color4ub Color4ub::Pack(float r, float g, float b, float a) {
+	auto unorm = [](float value) {
+		value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+		return (GLubyte)std::lround(value * 255.0f);
+	};
+	return { unorm(r), unorm(g), unorm(b), unorm(a) };
+}
+
+inline UV2h UV2h::Pack(float u, float v) {
+	return { ToHalf(u), ToHalf(v) };
+}
+
+inline Normal10_10_10_2 Normal10_10_10_2::Pack(float x, float y, float z, float w) {
+	// signed normalized: -1..1 onto -511..511 (and -1..1 for the 2 bit w)
+	auto snorm = [](float value, int bits) {
+		int most = (1 << (bits - 1)) - 1;
+		value = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+		return (GLuint)((int)std::lround(value * most) & ((1 << bits) - 1));
+	};
+	return { snorm(x, 10) | (snorm(y, 10) << 10) | (snorm(z, 10) << 20) | (snorm(w, 2) << 30) };
+}
+
+// the vertex struct itself: each attribute followed by the rest, so it's
+// standard layout and the offsets below can be worked out from sizeof/alignof
+template<typename... Attributes>
+struct VertexData;
+
+template<typename First>
+struct VertexData<First> {
+	First first;
+};
+
+template<typename First, typename... Rest>
+struct VertexData<First, Rest...> {
+	First first;
+	VertexData<Rest...> rest;
+};
+
+// an interleaved vertex of Attributes in that order, e.g.
+// VertexFormat<Position3f, Color3f, UV2f> is the 32 byte vertex default.vert reads
+template<typename... Attributes>
+struct VertexFormat {
+	typedef VertexData<Attributes...> Vertex;
+	static constexpr size_t count = sizeof...(Attributes);
+	static constexpr GLsizei stride = (GLsizei)sizeof(Vertex);
+
+	// builds one vertex, one value per attribute
+	static Vertex Make(const Attributes &... values) {
+		Vertex vertex;
+		assign(vertex, values...);
+		return vertex;
+	}
+
+	// links every attribute at its conventional location, so it works before the
+	// shader has linked. bind the VAO first, like LinkAttrib
+	static void Link(VAO &vao, VBO &vbo) {
+		link<Attributes...>(vao, vbo, 0);
+	}
+
+	// byte offset of the index-th attribute
+	template<size_t index>
+	static constexpr size_t Offset() {
+		return offsetOf<index, Attributes...>();
+	}
+
+	// the same attributes by name, for VAO::Link against a shader's reflection
+	static VertexLayout Layout() {
+		VertexLayout layout = { stride, {} };
+		describe<Attributes...>(layout, 0);
+		return layout;
+	}
+
+private:
+	template<typename First, typename... Rest>
+	static void assign(VertexData<First, Rest...> &vertex, const First &first, const Rest &... rest) {
+		vertex.first = first;
+		if constexpr (sizeof...(Rest) > 0) {
+			assign(vertex.rest, rest...);
+		}
+	}
+
+	// where VertexData puts its rest member, which is just as the compiler lays it out
+	template<typename First, typename... Rest>
+	static constexpr size_t restOffset() {
+		return (sizeof(First) + alignof(VertexData<Rest...>) - 1) / alignof(VertexData<Rest...>) * alignof(VertexData<Rest...>);
+	}
+
+	template<size_t index, typename First, typename... Rest>
+	static constexpr size_t offsetOf() {
+		if constexpr (index == 0) {
+			return 0;
+		} else {
+			return restOffset<First, Rest...>() + offsetOf<index - 1, Rest...>();
+		}
+	}
+
+	template<typename First, typename... Rest>
+	static void link(VAO &vao, VBO &vbo, size_t offset) {
+		vao.LinkAttrib(vbo, First::location, First::components, First::type, stride, (void*)offset, First::normalized);
+		if constexpr (sizeof...(Rest) > 0) {
+			link<Rest...>(vao, vbo, offset + restOffset<First, Rest...>());
+		}
+	}
+
+	template<typename First, typename... Rest>
+	static void describe(VertexLayout &layout, size_t offset) {
+		layout.attributes.push_back({ First::name, First::components, First::type, First::normalized, offset });
+		if constexpr (sizeof...(Rest) > 0) {
+			describe<Rest...>(layout, offset + restOffset<First, Rest...>());
+		}
+	}
+};
+
+// the formats the renderer uses, checked against the byte math they replace
+typedef VertexFormat<Position3f, Color3f, UV2f> QuadVertex;
+static_assert(QuadVertex::stride == 8 * sizeof(GLfloat) && QuadVertex::Offset<1>() == 3 * sizeof(GLfloat)
+	&& QuadVertex::Offset<2>() == 6 * sizeof(GLfloat), "QuadVertex should be x y z r g b u v");
+typedef VertexFormat<Position3f, Color4ub, UV2h> PackedQuadVertex;
+static_assert(PackedQuadVertex::stride == 20 && PackedQuadVertex::Offset<1>() == 12
+	&& PackedQuadVertex::Offset<2>() == 16, "PackedQuadVertex should be 12 + 4 + 4 bytes");
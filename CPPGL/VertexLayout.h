@@ -0,0 +1,23 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <vector>
+
+// one input of an interleaved vertex, matched to the shader by name instead of
+// a hard-coded location
+struct VertexAttribute {
+	// the "in" variable's name in the vertex shader
+	const char *name;
+	GLint components;
+	GLenum type;
+	// integer types only: map them to 0..1 (or -1..1) floats in the shader
+	GLboolean normalized;
+	size_t offset;
+};
+
+// how the vertices in a buffer are laid out, for VAO::Link
+struct VertexLayout {
+	GLsizei stride;
+	std::vector<VertexAttribute> attributes;
+};
@@ -0,0 +1,167 @@
+#include "VertexQuantizer.h"
+#include "Timing.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+	const double PI = 3.14159265358979323846;
+
+	// GLSL's sign() gives 0 for 0, which would fold the seam onto the wrong side
+	float signNotZero(float value) {
+		return value >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	// what GL does with a normalized short: -32768 and -32767 both land on -1
+	float fromSnorm16(GLshort value) {
+		return std::max(value / 32767.0f, -1.0f);
+	}
+
+	GLshort toSnorm16(float value) {
+		value = std::min(std::max(value, -1.0f), 1.0f);
+		return (GLshort)std::lround(value * 32767.0f);
+	}
+
+	GLushort toUnorm16(float value) {
+		value = std::min(std::max(value, 0.0f), 1.0f);
+		return (GLushort)std::lround(value * 65535.0f);
+	}
+}
+
+NormalOct16 VertexQuantizer::EncodeNormal(GLfloat x, GLfloat y, GLfloat z) {
+	// onto the octahedron |x| + |y| + |z| = 1, then the lower half folded over the upper
+	float length = std::fabs(x) + std::fabs(y) + std::fabs(z);
+	if (length == 0.0f) {
+		return { 0, 0 };
+	}
+	float u = x / length, v = y / length;
+	if (z < 0.0f) {
+		float foldedU = (1.0f - std::fabs(v)) * signNotZero(u);
+		float foldedV = (1.0f - std::fabs(u)) * signNotZero(v);
+		u = foldedU;
+		v = foldedV;
+	}
+	return { toSnorm16(u), toSnorm16(v) };
+}
+
+void VertexQuantizer::DecodeNormal(NormalOct16 normal, GLfloat &x, GLfloat &y, GLfloat &z) {
+	float u = fromSnorm16(normal.x), v = fromSnorm16(normal.y);
+	x = u;
+	y = v;
+	z = 1.0f - std::fabs(u) - std::fabs(v);
+	if (z < 0.0f) {
+		x = (1.0f - std::fabs(v)) * signNotZero(u);
+		y = (1.0f - std::fabs(u)) * signNotZero(v);
+	}
+	float length = std::sqrt(x * x + y * y + z * z);
+	x /= length;
+	y /= length;
+	z /= length;
+}
+
+VertexQuantizer::Bounds VertexQuantizer::Measure(const std::vector<MeshVertex::Vertex> &vertices) {
+	Bounds bounds = {};
+	if (vertices.empty()) {
+		return bounds;
+	}
+	GLfloat low[3], high[3];
+	const Position3f &first = vertices[0].first;
+	low[0] = high[0] = first.x;
+	low[1] = high[1] = first.y;
+	low[2] = high[2] = first.z;
+	for (const MeshVertex::Vertex &vertex : vertices) {
+		const GLfloat position[3] = { vertex.first.x, vertex.first.y, vertex.first.z };
+		for (int axis = 0; axis < 3; axis++) {
+			low[axis] = std::min(low[axis], position[axis]);
+			high[axis] = std::max(high[axis], position[axis]);
+		}
+	}
+	for (int axis = 0; axis < 3; axis++) {
+		bounds.min[axis] = low[axis];
+		bounds.extent[axis] = high[axis] - low[axis];
+	}
+	return bounds;
+}
+
+std::vector<QuantizedMeshVertex::Vertex> VertexQuantizer::Quantize(const std::vector<MeshVertex::Vertex> &vertices,
+	const Bounds &bounds, Report *report)
+{
+	auto start = std::chrono::steady_clock::now();
+	std::vector<QuantizedMeshVertex::Vertex> quantized;
+	quantized.reserve(vertices.size());
+	for (const MeshVertex::Vertex &vertex : vertices) {
+		const Position3f &position = vertex.first;
+		const Color3f &color = vertex.rest.first;
+		const UV2f &uv = vertex.rest.rest.first;
+		const Normal3f &normal = vertex.rest.rest.rest.first;
+		const GLfloat axes[3] = { position.x, position.y, position.z };
+		GLushort packed[3];
+		for (int axis = 0; axis < 3; axis++) {
+			// a flat axis has nowhere to go but min
+			packed[axis] = bounds.extent[axis] > 0.0f
+				? toUnorm16((axes[axis] - bounds.min[axis]) / bounds.extent[axis]) : 0;
+		}
+		quantized.push_back(QuantizedMeshVertex::Make(
+			Position3us{ packed[0], packed[1], packed[2], 0 },
+			Color4ub::Pack(color.r, color.g, color.b),
+			UV2h::Pack(uv.u, uv.v),
+			EncodeNormal(normal.x, normal.y, normal.z)));
+	}
+	if (report == NULL) {
+		return quantized;
+	}
+
+	*report = Report();
+	report->vertices = vertices.size();
+	report->bytesBefore = vertices.size() * MeshVertex::stride;
+	report->bytesAfter = quantized.size() * QuantizedMeshVertex::stride;
+	report->milliseconds = millisecondsSince(start);
+	float largest = std::max(bounds.extent[0], std::max(bounds.extent[1], bounds.extent[2]));
+	for (size_t i = 0; i < vertices.size(); i++) {
+		const MeshVertex::Vertex &before = vertices[i];
+		const QuantizedMeshVertex::Vertex &after = quantized[i];
+		const GLfloat axes[3] = { before.first.x, before.first.y, before.first.z };
+		const GLushort packed[3] = { after.first.x, after.first.y, after.first.z };
+		for (int axis = 0; axis < 3; axis++) {
+			double decoded = bounds.min[axis] + packed[axis] / 65535.0 * bounds.extent[axis];
+			report->maxPositionError = std::max(report->maxPositionError, std::fabs(decoded - axes[axis]));
+		}
+
+		const Color3f &color = before.rest.first;
+		const Color4ub &byteColor = after.rest.first;
+		const float channels[3] = { color.r, color.g, color.b };
+		const GLubyte bytes[3] = { byteColor.r, byteColor.g, byteColor.b };
+		for (int c = 0; c < 3; c++) {
+			int exact = (int)std::lround(std::min(std::max(channels[c], 0.0f), 1.0f) * 255.0f);
+			report->maxColorError = std::max(report->maxColorError, std::abs(exact - (int)bytes[c]));
+		}
+
+		const UV2f &uv = before.rest.rest.first;
+		const UV2h &halfUV = after.rest.rest.first;
+		report->maxUVError = std::max(report->maxUVError, (double)std::fabs(FromHalf(halfUV.u) - uv.u));
+		report->maxUVError = std::max(report->maxUVError, (double)std::fabs(FromHalf(halfUV.v) - uv.v));
+
+		const Normal3f &normal = before.rest.rest.rest.first;
+		float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		if (length > 0.0f) {
+			GLfloat x, y, z;
+			DecodeNormal(after.rest.rest.rest.first, x, y, z);
+			double cosine = (x * normal.x + y * normal.y + z * normal.z) / length;
+			double degrees = std::acos(std::min(std::max(cosine, -1.0), 1.0)) * 180.0 / PI;
+			report->maxNormalErrorDegrees = std::max(report->maxNormalErrorDegrees, degrees);
+		}
+	}
+	report->maxPositionErrorRelative = largest > 0.0f ? report->maxPositionError / largest : 0.0;
+	return quantized;
+}
+
+void VertexQuantizer::PrintReport(const Report &report) {
+	const double mb = 1024.0 * 1024.0;
+	printf("quantized %zu vertices in %.2f ms: %.2f MB -> %.2f MB (%.2fx smaller)\n", report.vertices,
+		report.milliseconds, report.bytesBefore / mb, report.bytesAfter / mb,
+		report.bytesAfter > 0 ? (double)report.bytesBefore / report.bytesAfter : 0.0);
+	printf("  max error: position %.3g (%.4f%% of the bounds), uv %.3g, color %d/255, normal %.3f degrees\n",
+		report.maxPositionError, report.maxPositionErrorRelative * 100.0, report.maxUVError,
+		report.maxColorError, report.maxNormalErrorDegrees);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include "VertexFormat.h"
+
+// a full precision mesh vertex, 44 bytes
+typedef VertexFormat<Position3f, Color3f, UV2f, Normal3f> MeshVertex;
+// the same vertex quantized, 20 bytes: positions as 16 bit fractions of the
+// mesh's bounding box, colors as normalized bytes, uvs as half floats and
+// normals octahedral encoded in two 16 bit values
+typedef VertexFormat<Position3us, Color4ub, UV2h, NormalOct16> QuantizedMeshVertex;
+static_assert(MeshVertex::stride == 44 && QuantizedMeshVertex::stride == 20,
+	"the quantized vertex should be under half the size of the full one");
+
+// turns full precision meshes into QuantizedMeshVertex. the normalized flags on
+// the attribute types take care of the GL side, so QuantizedMeshVertex::Link sets
+// the VAO up, and the shader (mesh.vert with QUANTIZED defined) only has to undo
+// the bounding box and unfold the normal
+namespace VertexQuantizer {
+	// quantized positions are min + value * extent, pass both to the shader
+	struct Bounds {
+		GLfloat min[3];
+		GLfloat extent[3];
+	};
+
+	// how far the quantized mesh strays from the original, decoded the way the GPU will
+	struct Report {
+		size_t vertices;
+		size_t bytesBefore;
+		size_t bytesAfter;
+		// in mesh units, the largest distance along any one axis
+		double maxPositionError;
+		// the same as a fraction of the bounding box's largest side
+		double maxPositionErrorRelative;
+		double maxUVError;
+		// out of 255
+		int maxColorError;
+		double maxNormalErrorDegrees;
+		double milliseconds;
+	};
+
+	Bounds Measure(const std::vector<MeshVertex::Vertex> &vertices);
+	// with the bounds from Measure, report is filled in if it isn't NULL
+	std::vector<QuantizedMeshVertex::Vertex> Quantize(const std::vector<MeshVertex::Vertex> &vertices,
+		const Bounds &bounds, Report *report = NULL);
+	void PrintReport(const Report &report);
+
+	// the encoding mesh.vert undoes, exposed for tools and the error report
+	NormalOct16 EncodeNormal(GLfloat x, GLfloat y, GLfloat z);
+	void DecodeNormal(NormalOct16 normal, GLfloat &x, GLfloat &y, GLfloat &z);
+}
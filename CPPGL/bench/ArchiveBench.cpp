@@ -0,0 +1,226 @@
+#include "Bench.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include "AssetArchive.h"
+#include "CookedTexture.h"
+#include "Scene.h"
+#include "Texture.h"
+#include "VBO.h"
+#include "shaderClass.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// asks the kernel to forget a file's cached pages, so the next read comes off the
+// disk. only clean pages go, so it's written back first. false where it can't
+static bool evictFromPageCache(const std::string &path) {
+#ifdef __linux__
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	fdatasync(fd);
+	bool evicted = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+	close(fd);
+	return evicted;
+#else
+	(void)path;
+	return false;
+#endif
+}
+
+namespace {
+	struct Assets {
+		std::vector<std::string> shaders;
+		std::vector<std::string> textures;
+		std::vector<std::string> meshes;
+	};
+
+	// what a run read, so the work can't be optimized away and the runs can be compared
+	struct Loaded {
+		unsigned long long checksum = 0;
+		size_t bytes = 0;
+		int failed = 0;
+	};
+
+	void addChecksum(Loaded &loaded, const unsigned char *bytes, size_t size) {
+		// one byte a page is enough to fault the whole thing in
+		for (size_t i = 0; i < size; i += 4096) {
+			loaded.checksum += bytes[i];
+		}
+		loaded.bytes += size;
+	}
+}
+
+// options.assets files split between shader sources, small cooked textures and
+// meshes, loaded once as loose files (open, read, close each) and once from an
+// archive of the same files (one map, then views), stored and lz compressed.
+// each is timed cold, with the files evicted from the page cache first, and warm
+void runArchiveBench(const BenchOptions &options, HeadlessContext &, Scene &) {
+	const std::filesystem::path directory = "archive_bench";
+	const std::string archivePath = "archive_bench.pak";
+	const std::string compressedPath = "archive_bench_lz.pak";
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+	std::filesystem::create_directories(directory / "shaders", error);
+	std::filesystem::create_directories(directory / "textures", error);
+	std::filesystem::create_directories(directory / "meshes", error);
+
+	// a third of each, all a little different so compression can't just dedupe them
+	std::string vertex = get_file_contents("default.vert");
+	std::vector<unsigned char> pixels(64 * 64 * 4);
+	Assets assets;
+	std::vector<AssetArchive::Input> inputs;
+	unsigned int seed = 1;
+	for (int i = 0; i < options.assets; i++) {
+		std::string name;
+		switch (i % 3) {
+		case 0: {
+			name = "shaders/" + std::to_string(i) + ".vert";
+			std::ofstream out((directory / name).string(), std::ios::binary);
+			out << "// variant " << i << "\n" << vertex;
+			assets.shaders.push_back(name);
+			break;
+		}
+		case 1: {
+			name = "textures/" + std::to_string(i) + ".ctex";
+			for (size_t p = 0; p < pixels.size(); p++) {
+				pixels[p] = (unsigned char)((p * (i + 1)) >> 5);
+			}
+			CookedTexture::Write((directory / name).string().c_str(), pixels.data(), 64, 64, CookedTexture::Options());
+			assets.textures.push_back(name);
+			break;
+		}
+		default: {
+			// positions on a bumpy grid plus uvs, somewhere between 4 and 32 KB
+			name = "meshes/" + std::to_string(i) + ".bin";
+			std::vector<float> vertices((size_t)(1024 + i % 7 * 1024));
+			for (size_t v = 0; v < vertices.size(); v++) {
+				seed = seed * 1664525u + 1013904223u;
+				vertices[v] = (float)(v % 5) + (float)(seed >> 24) / 256.0f;
+			}
+			std::ofstream out((directory / name).string(), std::ios::binary);
+			out.write((const char*)vertices.data(), (std::streamsize)(vertices.size() * sizeof(float)));
+			assets.meshes.push_back(name);
+			break;
+		}
+		}
+		inputs.push_back({ name, (directory / name).string() });
+	}
+	AssetArchive::PackOptions packOptions;
+	AssetArchive::PackReport stored, compressed;
+	if (!AssetArchive::Pack(archivePath.c_str(), inputs, packOptions, &stored)) {
+		return;
+	}
+	packOptions.compress = true;
+	if (!AssetArchive::Pack(compressedPath.c_str(), inputs, packOptions, &compressed)) {
+		return;
+	}
+	printf("[archive] %d assets, %.1f MB loose, %.1f MB packed, %.1f MB compressed (%u of them)\n",
+		options.assets, stored.rawBytes / (1024.0 * 1024.0), stored.bytes / (1024.0 * 1024.0),
+		compressed.bytes / (1024.0 * 1024.0), compressed.compressed);
+
+	auto loadLoose = [&]() {
+		Loaded loaded;
+		for (const std::string &name : assets.shaders) {
+			std::string source = get_file_contents((directory / name).string().c_str());
+			addChecksum(loaded, (const unsigned char*)source.data(), source.size());
+		}
+		std::vector<Texture> textures;
+		textures.reserve(assets.textures.size());
+		for (const std::string &name : assets.textures) {
+			textures.push_back(Texture::FromCooked((directory / name).string().c_str()));
+			loaded.failed += textures.back().Ready() ? 0 : 1;
+		}
+		std::vector<VBO> meshes;
+		meshes.reserve(assets.meshes.size());
+		for (const std::string &name : assets.meshes) {
+			std::string bytes = get_file_contents((directory / name).string().c_str());
+			addChecksum(loaded, (const unsigned char*)bytes.data(), bytes.size());
+			meshes.emplace_back(bytes.data(), (GLsizeiptr)bytes.size());
+		}
+		glFinish();
+		return loaded;
+	};
+	auto loadArchive = [&](const std::string &path) {
+		Loaded loaded;
+		AssetArchive archive(path.c_str());
+		std::vector<unsigned char> unpacked;
+		// the bytes of an asset, from the mapping when they can be
+		auto read = [&](const std::string &name, const unsigned char *&bytes, size_t &size) {
+			AssetArchive::View view = archive.Find(name);
+			if (view.Found() && view.compression == AssetArchive::NONE) {
+				bytes = view.data;
+				size = view.size;
+				return true;
+			}
+			if (!archive.Read(name, unpacked)) {
+				return false;
+			}
+			bytes = unpacked.data();
+			size = unpacked.size();
+			return true;
+		};
+		const unsigned char *bytes;
+		size_t size;
+		for (const std::string &name : assets.shaders) {
+			if (read(name, bytes, size)) {
+				addChecksum(loaded, bytes, size);
+			} else {
+				loaded.failed++;
+			}
+		}
+		std::vector<Texture> textures;
+		textures.reserve(assets.textures.size());
+		for (const std::string &name : assets.textures) {
+			textures.push_back(Texture::FromCooked(archive, name.c_str()));
+			loaded.failed += textures.back().Ready() ? 0 : 1;
+		}
+		std::vector<VBO> meshes;
+		meshes.reserve(assets.meshes.size());
+		for (const std::string &name : assets.meshes) {
+			if (read(name, bytes, size)) {
+				addChecksum(loaded, bytes, size);
+				meshes.emplace_back(bytes, (GLsizeiptr)size);
+			} else {
+				loaded.failed++;
+			}
+		}
+		glFinish();
+		return loaded;
+	};
+
+	auto run = [&](const char *name, const std::vector<std::string> &files, const std::function<Loaded()> &load) {
+		bool evicted = true;
+		for (const std::string &file : files) {
+			evicted = evictFromPageCache(file) && evicted;
+		}
+		auto start = std::chrono::steady_clock::now();
+		Loaded cold = load();
+		double coldMs = millisecondsSince(start);
+		start = std::chrono::steady_clock::now();
+		Loaded warm = load();
+		double warmMs = millisecondsSince(start);
+		printf("  %-10s cold %8.2f ms%s  warm %8.2f ms  %.1f MB of shaders and meshes, checksum %llu%s\n", name, coldMs,
+			evicted ? "" : " (couldn't evict)", warmMs, warm.bytes / (1024.0 * 1024.0), warm.checksum,
+			cold.failed + warm.failed > 0 ? ", SOME FAILED" : "");
+	};
+	std::vector<std::string> looseFiles;
+	for (const AssetArchive::Input &input : inputs) {
+		looseFiles.push_back(input.path);
+	}
+	run("loose", looseFiles, loadLoose);
+	run("archive", { archivePath }, [&]() { return loadArchive(archivePath); });
+	run("archive lz", { compressedPath }, [&]() { return loadArchive(compressedPath); });
+
+	std::filesystem::remove_all(directory, error);
+	std::filesystem::remove(archivePath, error);
+	std::filesystem::remove(compressedPath, error);
+}
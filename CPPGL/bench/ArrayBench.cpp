@@ -0,0 +1,92 @@
+#include "Bench.h"
+#include <algorithm>
+#include <cstdio>
+#include <set>
+#include <vector>
+#include "Samplers.h"
+#include "SpriteBatch.h"
+#include "Texture.h"
+#include "TextureArray.h"
+
+// sprites cycling through 64 same-sized tiles: every tile its own texture with
+// its own parameters, versus one texture array where the tile is a layer index
+// and the filtering comes from a shared sampler
+void runArrayBench(const BenchOptions &options, HeadlessContext &context, Scene &) {
+	const int tileCount = 64;
+	const GLsizei tileSize = 32;
+	// a draw per sprite is slow enough that the default sprite count would take minutes
+	const int spriteCount = std::min(options.sprites, 10000);
+
+	std::vector<std::vector<unsigned char>> tiles(tileCount);
+	for (int i = 0; i < tileCount; i++) {
+		tiles[i].resize((size_t)tileSize * tileSize * 4);
+		for (size_t p = 0; p < tiles[i].size(); p++) {
+			tiles[i][p] = (p & 3) == 3 ? 255 : (unsigned char)(i * 37 + (p & 3) * 80);
+		}
+	}
+
+	// every texture sets its own four parameters, but they only need two samplers between them
+	std::set<GLuint> samplers;
+	std::vector<Texture> textures;
+	for (int i = 0; i < tileCount; i++) {
+		GLint filter = i % 2 == 0 ? GL_NEAREST : GL_LINEAR;
+		textures.emplace_back(tiles[i].data(), tileSize, tileSize, filter);
+		samplers.insert(Samplers::Get(filter, GL_CLAMP_TO_EDGE));
+	}
+	printf("[arrays] %d textures with their own parameters, %zu shared samplers would cover them\n",
+		tileCount, samplers.size());
+
+	auto report = [](SpriteBatch &batch) {
+		SpriteBatch::Stats stats = batch.GetStats();
+		printf("  sprite batch %u sprites in %u draws (%u texture flushes, %u capacity flushes)\n",
+			stats.sprites, stats.draws, stats.textureFlushes, stats.capacityFlushes);
+	};
+	auto clear = []() {
+		glClearColor(0.07f, 0.13f, 0.17f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+	};
+
+	Shader spriteShader("sprite.vert", "sprite.frag");
+	SpriteBatch batch(spriteShader);
+	auto drawSeparate = [&]() {
+		clear();
+		batch.Begin((GLfloat)options.width, (GLfloat)options.height);
+		for (int i = 0; i < spriteCount; i++) {
+			batch.Draw(textures[i % tileCount].ID, (GLfloat)(i * 37 % options.width),
+				(GLfloat)(i * 91 % options.height), 8.0f, 8.0f);
+		}
+		batch.End();
+	};
+	runFrames("arrays separate", options, context, drawSeparate);
+	report(batch);
+	drawSeparate();
+	unsigned long long separateImage = checksum(options);
+	textures.clear();
+
+	TextureArray array(tileSize, tileSize, tileCount);
+	for (int i = 0; i < tileCount; i++) {
+		array.SetLayer(i, tiles[i].data());
+	}
+	Shader arrayShader("sprite_array.vert", "sprite_array.frag");
+	SpriteBatch arrayBatch(arrayShader);
+	arrayBatch.sampler = Samplers::Get(GL_NEAREST, GL_CLAMP_TO_EDGE);
+	auto drawLayered = [&]() {
+		clear();
+		arrayBatch.Begin((GLfloat)options.width, (GLfloat)options.height);
+		for (int i = 0; i < spriteCount; i++) {
+			arrayBatch.DrawLayer(array.ID, (GLushort)(i % tileCount), (GLfloat)(i * 37 % options.width),
+				(GLfloat)(i * 91 % options.height), 8.0f, 8.0f);
+		}
+		arrayBatch.End();
+	};
+	runFrames("arrays layered", options, context, drawLayered);
+	report(arrayBatch);
+	drawLayered();
+	unsigned long long layeredImage = checksum(options);
+	printf("  image        %s\n", separateImage == layeredImage ? "same both ways" : "DIFFERENT");
+
+	// the pumpkin cut into quarters, as if it were a four frame sprite sheet
+	TextureArray sheet("pumpkin panic 2 1x.png", 64, 64);
+	printf("[arrays] sprite sheet sliced into %d layers of %dx%d, %zu samplers in use\n",
+		sheet.layers, sheet.width, sheet.height, Samplers::Count());
+}
@@ -0,0 +1,105 @@
+#include "Bench.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "Atlas.h"
+#include "SpriteBatch.h"
+#include "Texture.h"
+
+// sprites cycling through 256 small images, first with every image in its own
+// texture, then with all of them packed into an atlas, then after evicting half
+// the atlas and filling the gaps with new images
+void runAtlasBench(const BenchOptions &options, HeadlessContext &context, Scene &) {
+	const int imageCount = 256;
+	// a draw per sprite is slow enough that the default sprite count would take minutes
+	const int spriteCount = std::min(options.sprites, 10000);
+	std::mt19937 random(1234);
+	std::uniform_int_distribution<int> side(8, 64);
+	std::uniform_int_distribution<int> channel(0, 255);
+
+	struct Image {
+		std::string name;
+		GLsizei width, height;
+		std::vector<unsigned char> pixels;
+	};
+	auto makeImage = [&](const std::string &name) {
+		Image image = { name, side(random), side(random), {} };
+		unsigned char color[4] = { (unsigned char)channel(random), (unsigned char)channel(random),
+			(unsigned char)channel(random), 255 };
+		image.pixels.resize((size_t)image.width * image.height * 4);
+		for (size_t i = 0; i < image.pixels.size(); i++) {
+			image.pixels[i] = color[i & 3];
+		}
+		return image;
+	};
+	std::vector<Image> images;
+	for (int i = 0; i < imageCount; i++) {
+		images.push_back(makeImage("image" + std::to_string(i)));
+	}
+
+	Shader spriteShader("sprite.vert", "sprite.frag");
+	SpriteBatch batch(spriteShader);
+	auto report = [&]() {
+		SpriteBatch::Stats stats = batch.GetStats();
+		printf("  sprite batch %u sprites in %u draws (%u texture flushes, %u capacity flushes)\n",
+			stats.sprites, stats.draws, stats.textureFlushes, stats.capacityFlushes);
+	};
+	auto drawSprites = [&](const std::function<void(int, GLfloat, GLfloat)> &draw) {
+		glClearColor(0.07f, 0.13f, 0.17f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		batch.Begin((GLfloat)options.width, (GLfloat)options.height);
+		for (int i = 0; i < spriteCount; i++) {
+			draw(i % imageCount, (GLfloat)(i * 37 % options.width), (GLfloat)(i * 91 % options.height));
+		}
+		batch.End();
+	};
+
+	std::vector<Texture> textures;
+	for (const Image &image : images) {
+		textures.emplace_back(image.pixels.data(), image.width, image.height);
+	}
+	runFrames("atlas separate", options, context, [&]() {
+		drawSprites([&](int image, GLfloat x, GLfloat y) {
+			batch.Draw(textures[image].ID, x, y, 8.0f, 8.0f);
+		});
+	});
+	report();
+	textures.clear();
+
+	Atlas atlas(1024);
+	for (const Image &image : images) {
+		atlas.Insert(image.name, image.pixels.data(), image.width, image.height);
+	}
+	atlas.Pack({ "pumpkin panic 2 1x.png" });
+	std::vector<const AtlasRegion*> regions;
+	for (const Image &image : images) {
+		regions.push_back(atlas.Find(image.name));
+	}
+	Atlas::Stats packed = atlas.GetStats();
+	printf("[atlas] %d images on %d pages of 1024x1024, %.1f%% occupied\n",
+		packed.images, packed.pages, packed.occupancy * 100.0f);
+	runFrames("atlas packed", options, context, [&]() {
+		drawSprites([&](int image, GLfloat x, GLfloat y) {
+			const AtlasRegion *region = regions[image];
+			batch.Draw(region->texture, x, y, 8.0f, 8.0f, region->uv);
+		});
+	});
+	report();
+
+	// churn: evict every other image and put new ones of different sizes in their place
+	int misses = 0;
+	for (int i = 0; i < imageCount; i += 2) {
+		atlas.Evict(images[i].name);
+	}
+	for (int i = 0; i < imageCount; i += 2) {
+		images[i] = makeImage(images[i].name);
+		if (!atlas.Insert(images[i].name, images[i].pixels.data(), images[i].width, images[i].height)) {
+			misses++;
+		}
+	}
+	Atlas::Stats churned = atlas.GetStats();
+	printf("[atlas] after evicting and refilling half: %d images on %d pages, %.1f%% occupied, %d didn't fit\n",
+		churned.images, churned.pages, churned.occupancy * 100.0f, misses);
+}
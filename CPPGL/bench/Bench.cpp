@@ -0,0 +1,151 @@
+#include "Bench.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "GLState.h"
+#include "GLStats.h"
+#include "Scene.h"
+#include "UniformBlocks.h"
+
+// nearest-rank percentile of an already sorted list
+static double percentile(const std::vector<double> &sorted, double p) {
+	size_t rank = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+	return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+double runFrames(const char *name, const BenchOptions &options, HeadlessContext &context,
+	const std::function<void()> &draw) {
+	for (int i = 0; i < options.warmup; i++) {
+		draw();
+		context.Present();
+	}
+
+	std::vector<double> frameMs;
+	frameMs.reserve(options.frames);
+	GLStats::Reset();
+	GLState::ResetCounters();
+
+	auto benchStart = std::chrono::steady_clock::now();
+	for (int i = 0; i < options.frames; i++) {
+		auto frameStart = std::chrono::steady_clock::now();
+		draw();
+		context.Present();
+		auto frameEnd = std::chrono::steady_clock::now();
+		frameMs.push_back(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+	}
+	double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - benchStart).count();
+
+	std::vector<GLStats::Entry> calls = GLStats::Snapshot();
+	unsigned long long totalCalls = GLStats::Total();
+	GLState::Counters binds = GLState::GetCounters();
+
+	std::sort(frameMs.begin(), frameMs.end());
+	double meanMs = 0.0;
+	for (double ms : frameMs) {
+		meanMs += ms;
+	}
+	meanMs /= frameMs.size();
+
+	printf("[%s] %d frames in %.3f s\n", name, options.frames, totalSeconds);
+	printf("  fps          %.1f\n", options.frames / totalSeconds);
+	printf("  ms/frame     mean %.3f  p50 %.3f  p90 %.3f  p99 %.3f  max %.3f\n",
+		meanMs, percentile(frameMs, 50), percentile(frameMs, 90), percentile(frameMs, 99), frameMs.back());
+	printf("  gl calls     %.1f/frame (%llu total)\n", (double)totalCalls / options.frames, totalCalls);
+	printf("  binds        %.1f issued/frame, %.1f skipped/frame by the state cache\n",
+		(double)binds.issued / options.frames, (double)binds.skipped / options.frames);
+
+	std::sort(calls.begin(), calls.end(), [](const GLStats::Entry &a, const GLStats::Entry &b) {
+		return a.count > b.count;
+	});
+	for (const GLStats::Entry &entry : calls) {
+		printf("    %-28s %.1f/frame\n", entry.name, (double)entry.count / options.frames);
+	}
+	return totalSeconds;
+}
+
+std::vector<unsigned char> readPixels(const BenchOptions &options) {
+	std::vector<unsigned char> pixels((size_t)options.width * options.height * 4);
+	glReadPixels(0, 0, options.width, options.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	return pixels;
+}
+
+unsigned long long checksum(const BenchOptions &options) {
+	unsigned long long hash = 1469598103934665603ull;
+	for (unsigned char byte : readPixels(options)) {
+		hash = (hash ^ byte) * 1099511628211ull;
+	}
+	return hash;
+}
+
+void printImageDifference(const std::vector<unsigned char> &a, const std::vector<unsigned char> &b) {
+	int most = 0;
+	size_t differing = 0;
+	double total = 0.0;
+	for (size_t i = 0; i < a.size() && i < b.size(); i++) {
+		int difference = abs((int)a[i] - (int)b[i]);
+		most = difference > most ? difference : most;
+		differing += difference > 0 ? 1 : 0;
+		total += difference;
+	}
+	size_t channels = a.size() > 0 ? a.size() : 1;
+	printf("  image        %zu channels differ (%.2f%%), by %.4f/255 on average and at most %d/255\n", differing,
+		100.0 * differing / channels, total / channels, most);
+}
+
+void waitForScene(HeadlessContext &context, Scene &scene) {
+	while (!(scene.shaderReady && scene.texture.Ready())) {
+		scene.Draw();
+		context.Present();
+	}
+}
+
+RipplePoint ripple(float u, float v, float extent) {
+	const float frequency = 40.0f, height = 0.01f;
+	float px = (u * 2.0f - 1.0f) * extent, py = (v * 2.0f - 1.0f) * extent;
+	float pz = height * std::sin(px * frequency) * std::cos(py * frequency);
+	// the surface's gradient, crossed into a normal
+	float dx = height * frequency * std::cos(px * frequency) * std::cos(py * frequency);
+	float dy = -height * frequency * std::sin(px * frequency) * std::sin(py * frequency);
+	float length = std::sqrt(dx * dx + dy * dy + 1.0f);
+	return {
+		Position3f{ px, py, pz },
+		Color3f{ u, v, 1.0f - u * v },
+		UV2f{ u, v },
+		Normal3f{ -dx / length, -dy / length, 1.0f / length }
+	};
+}
+
+std::vector<GLuint> gridIndices(int cells) {
+	std::vector<GLuint> indices;
+	indices.reserve((size_t)cells * cells * 6);
+	for (int y = 0; y < cells; y++) {
+		for (int x = 0; x < cells; x++) {
+			GLuint corner = y * (cells + 1) + x;
+			GLuint above = corner + cells + 1;
+			indices.insert(indices.end(), { corner, corner + 1, above + 1, corner, above + 1, above });
+		}
+	}
+	return indices;
+}
+
+double drawIndexed(const char *name, Shader &shader, VAO &vao, GLsizei count, int draws,
+	const BenchOptions &options, HeadlessContext &context, Scene &scene)
+{
+	auto draw = [&]() {
+		glClearColor(0.07f, 0.13f, 0.17f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		scene.frameUniforms.BindBase(UniformBlocks::FRAME);
+		shader.Activate();
+		scene.texture.Bind(0);
+		vao.Bind();
+		for (int i = 0; i < draws; i++) {
+			glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, 0);
+		}
+	};
+	double seconds = runFrames(name, options, context, draw);
+	// one more for readPixels to see
+	draw();
+	return seconds;
+}
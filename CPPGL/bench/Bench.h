@@ -0,0 +1,116 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "EBO.h"
+#include "HeadlessContext.h"
+#include "VAO.h"
+#include "VBO.h"
+#include "VertexFormat.h"
+#include "shaderClass.h"
+// millisecondsSince, for timing the steps a bench does outside runFrames
+#include "Timing.h"
+
+class Scene;
+
+struct BenchOptions {
+	int frames = 1000;
+	int warmup = 50;
+	int width = 800;
+	int height = 800;
+	std::string shaderCache = "shader_cache";
+	bool useShaderCache = true;
+	// which scenarios to run, just "quad" if none are given
+	std::vector<std::string> scenarios;
+	int sprites = 100000;
+	std::vector<int> instances = { 10000, 100000, 1000000 };
+	double streamMB = 4.0;
+	int textures = 500;
+	// TextureLoader upload budget per frame
+	size_t uploadKB = 1024;
+	// files the archive scenario packs
+	int assets = 3000;
+};
+
+// draws warmup + frames frames, timing each one from the first GL call to the
+// end of Present(), and prints fps, ms/frame percentiles and GL calls/frame
+// returns how long the timed frames took, in seconds
+double runFrames(const char *name, const BenchOptions &options, HeadlessContext &context,
+	const std::function<void()> &draw);
+// what's been drawn so far, the whole view as rgba bytes
+std::vector<unsigned char> readPixels(const BenchOptions &options);
+// a hash of readPixels, so two ways of drawing can be checked for drawing the same thing
+unsigned long long checksum(const BenchOptions &options);
+// prints how many channels of two readPixels images differ, on average and at most
+void printImageDifference(const std::vector<unsigned char> &a, const std::vector<unsigned char> &b);
+// draws the scene until its program and texture are in, like the window would wait
+void waitForScene(HeadlessContext &context, Scene &scene);
+
+// the vertex format benches draw a rippled sheet over -extent..extent, so the
+// normals and the z range have something in them. u and v go 0..1 across it
+struct RipplePoint {
+	Position3f position;
+	Color3f color;
+	UV2f uv;
+	Normal3f normal;
+};
+RipplePoint ripple(float u, float v, float extent);
+// (cells + 1)^2 vertices, row by row, one make(u, v) each
+template<typename Format, typename MakeVertex>
+std::vector<typename Format::Vertex> gridVertices(int cells, MakeVertex make) {
+	std::vector<typename Format::Vertex> vertices;
+	vertices.reserve((size_t)(cells + 1) * (cells + 1));
+	for (int y = 0; y <= cells; y++) {
+		for (int x = 0; x <= cells; x++) {
+			vertices.push_back(make((float)x / cells, (float)y / cells));
+		}
+	}
+	return vertices;
+}
+// two triangles per cell of gridVertices
+std::vector<GLuint> gridIndices(int cells);
+
+// runFrames over a VAO already linked for shader, count indices draws times a
+// frame with the scene's frame block and texture. returns the seconds it took
+double drawIndexed(const char *name, Shader &shader, VAO &vao, GLsizei count, int draws,
+	const BenchOptions &options, HeadlessContext &context, Scene &scene);
+// vertices in Format uploaded and checked against shader, then drawIndexed.
+// seconds gets the time the frames took, the last frame is read back
+template<typename Format>
+std::vector<unsigned char> drawFormat(const char *name, Shader &shader,
+	const std::vector<typename Format::Vertex> &vertices, const std::vector<GLuint> &indices, int draws,
+	const BenchOptions &options, HeadlessContext &context, Scene &scene, double &seconds)
+{
+	VAO vao;
+	vao.Bind();
+	VBO vbo(vertices.data(), vertices.size() * sizeof(typename Format::Vertex));
+	EBO ebo(indices.data(), indices.size() * sizeof(GLuint));
+	Format::Link(vao, vbo);
+	vao.Unbind();
+	vbo.Unbind();
+	vao.Validate(shader);
+	seconds = drawIndexed(name, shader, vao, (GLsizei)indices.size(), draws, options, context, scene);
+	return readPixels(options);
+}
+
+// scenarios, each in its own file. they all get the main scene for its texture
+void runSpriteBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runInstanceBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runStreamBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runUpdateBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runTextureBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runUploadBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runAtlasBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runArrayBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runCookedBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runCompressedBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runMipBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runResidencyBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runArchiveBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runReloadBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runVariantBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runUniformBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runReflectionBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runFormatBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
+void runQuantizeBench(const BenchOptions &options, HeadlessContext &context, Scene &scene);
@@ -0,0 +1,109 @@
+#include "Bench.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <vector>
+#include "BlockCompression.h"
+#include "CookedTexture.h"
+#include "GLExtensions.h"
+#include "MappedFile.h"
+#include "Scene.h"
+#include "Texture.h"
+#include "stb/stb_image.h"
+
+namespace {
+	const char *formatNames[] = { "bc1", "bc3", "bc7" };
+	const char *qualityNames[] = { "fast", "normal", "best" };
+
+	// smooth opaque colour ramps, the kind of image block compression is made
+	// for, unlike the hard edged pixel art. opaque so bc1's one bit alpha isn't
+	// what gets measured
+	std::vector<unsigned char> gradient(int size) {
+		std::vector<unsigned char> pixels((size_t)size * size * 4);
+		for (int y = 0; y < size; y++) {
+			for (int x = 0; x < size; x++) {
+				float u = (x + 0.5f) / size, v = (y + 0.5f) / size;
+				unsigned char *pixel = &pixels[((size_t)y * size + x) * 4];
+				pixel[0] = (unsigned char)std::lround(u * 255.0f);
+				pixel[1] = (unsigned char)std::lround(v * 255.0f);
+				pixel[2] = (unsigned char)std::lround((0.5f + 0.5f * std::sin(u * 3.0f + v * 2.0f)) * 255.0f);
+				pixel[3] = 255;
+			}
+		}
+		return pixels;
+	}
+
+	// one image in every block format at every quality, loaded back each time
+	void cookAll(const char *name, const unsigned char *pixels, int width, int height) {
+		const char *cooked = "compressed bench.ctex";
+		size_t rawBytes;
+		{
+			Texture raw(pixels, width, height);
+			rawBytes = raw.Bytes();
+		}
+		printf("[compressed] %s, %dx%d, rgba8 with mips takes %.1f KB on the GPU (s3tc %s, bptc %s)\n", name,
+			width, height, rawBytes / 1024.0, GLExtensions::EXT_texture_compression_s3tc ? "yes" : "no",
+			GLExtensions::texture_compression_bptc ? "yes" : "no");
+
+		for (int format = BlockCompression::BC1; format <= BlockCompression::BC7; format++) {
+			for (int quality = BlockCompression::FAST; quality <= BlockCompression::BEST; quality++) {
+				CookedTexture::Options cook;
+				cook.compress = true;
+				cook.compression = (BlockCompression::Format)format;
+				cook.quality = (BlockCompression::Quality)quality;
+				CookedTexture::Report report;
+				if (!CookedTexture::Write(cooked, pixels, width, height, cook, &report)) {
+					continue;
+				}
+				printf("  %s %-6s  %6.1f KB (%.1fx smaller)  %6.2f dB  encode %7.2f ms", formatNames[format],
+					qualityNames[quality], report.bytes / 1024.0, (double)rawBytes / report.bytes, report.psnr,
+					report.encodeMs);
+
+				Texture texture = Texture::FromCooked(cooked);
+				if (!texture.Ready()) {
+					printf("\n");
+					continue;
+				}
+				// the driver's decode of level 0 against ours, they should match to a step or two
+				std::vector<unsigned char> gpu((size_t)width * height * 4);
+				texture.Bind(0);
+				glPixelStorei(GL_PACK_ALIGNMENT, 1);
+				glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, gpu.data());
+				MappedFile file(cooked);
+				CookedTexture::View view;
+				CookedTexture::Parse(file.Data(), file.Size(), view);
+				std::vector<unsigned char> cpu = BlockCompression::Decode((BlockCompression::Format)format,
+					view.Pixels(0), width, height);
+				int worst = 0;
+				for (size_t i = 0; i < cpu.size(); i++) {
+					worst = std::max(worst, abs(cpu[i] - gpu[i]));
+				}
+				printf("  gpu %.1f KB, gpu vs cpu decode off by %d at most\n", texture.Bytes() / 1024.0, worst);
+			}
+		}
+		std::error_code error;
+		std::filesystem::remove(cooked, error);
+	}
+}
+
+// cooks the pumpkin and a smooth 256x256 gradient in every block format at
+// every quality and loads them back: how much smaller each is on the GPU, how
+// close the cpu decode is to the source, and whether the driver's own decode
+// (read back with glGetTexImage) agrees with the cpu one
+void runCompressedBench(const BenchOptions &, HeadlessContext &, Scene &) {
+	const char *png = "pumpkin panic 2 1x.png";
+	int width, height, channels;
+	unsigned char *pixels = stbi_load(png, &width, &height, &channels, 4);
+	if (pixels == NULL) {
+		printf("[compressed] couldn't load %s: %s\n", png, stbi_failure_reason());
+	} else {
+		cookAll(png, pixels, width, height);
+		stbi_image_free(pixels);
+	}
+
+	const int size = 256;
+	std::vector<unsigned char> smooth = gradient(size);
+	cookAll("gradient", smooth.data(), size, size);
+}
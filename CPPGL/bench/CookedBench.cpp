@@ -0,0 +1,57 @@
+#include "Bench.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+#include "CookedTexture.h"
+#include "Scene.h"
+#include "Texture.h"
+
+// loads options.textures copies of the pumpkin on the GL thread, first from the
+// png (decode, upload, glGenerateMipmap) and then from a .ctex cooked from it
+// (map, upload every level). the file is the same each time so both sides read
+// it from the page cache, what's left is the decoding and the mip building
+void runCookedBench(const BenchOptions &options, HeadlessContext &, Scene &) {
+	const char *png = "pumpkin panic 2 1x.png";
+	const char *cooked = "pumpkin panic 2 1x.ctex";
+	if (!CookedTexture::Cook(png, cooked, CookedTexture::Options())) {
+		return;
+	}
+	std::error_code error;
+	printf("[cooked] %d textures, png %ju bytes, ctex %ju bytes (with mips)\n", options.textures,
+		(uintmax_t)std::filesystem::file_size(png, error), (uintmax_t)std::filesystem::file_size(cooked, error));
+
+	double pngMs;
+	{
+		std::vector<Texture> textures;
+		textures.reserve(options.textures);
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < options.textures; i++) {
+			textures.emplace_back(png);
+		}
+		glFinish();
+		pngMs = millisecondsSince(start);
+	}
+
+	double cookedMs;
+	int failed = 0;
+	{
+		std::vector<Texture> textures;
+		textures.reserve(options.textures);
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < options.textures; i++) {
+			textures.push_back(Texture::FromCooked(cooked));
+			failed += textures.back().Ready() ? 0 : 1;
+		}
+		glFinish();
+		cookedMs = millisecondsSince(start);
+	}
+
+	printf("  png          %.2f ms total, %.3f ms per texture\n", pngMs, pngMs / options.textures);
+	printf("  cooked       %.2f ms total, %.3f ms per texture (%.1fx)\n", cookedMs, cookedMs / options.textures,
+		pngMs / cookedMs);
+	if (failed > 0) {
+		printf("  %d cooked textures failed to load\n", failed);
+	}
+	std::filesystem::remove(cooked, error);
+}
@@ -0,0 +1,72 @@
+#include "Bench.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Scene.h"
+#include "VertexQuantizer.h"
+
+namespace {
+	// cells per side of the grid, so (CELLS + 1)^2 vertices
+	const int CELLS = 256;
+	// drawn this many times a frame, squeezed into the middle of the view so
+	// the vertices cost more than the pixels
+	const int DRAWS = 2;
+	const float EXTENT = 0.15f;
+
+	// normalized byte colors and half float uvs, the normals left as floats
+	typedef VertexFormat<Position3f, Color4ub, UV2h, Normal3f> PackedColorVertex;
+	// and the normals packed too, into signed 10_10_10_2
+	typedef VertexFormat<Position3f, Color4ub, UV2h, Normal10_10_10_2> PackedNormalVertex;
+
+	// one grid in one format, drawn with the bench's program
+	template<typename Format>
+	std::vector<unsigned char> run(const char *name, Shader &shader, const std::vector<typename Format::Vertex> &vertices,
+		const std::vector<GLuint> &indices, const BenchOptions &options, HeadlessContext &context, Scene &scene)
+	{
+		std::string label = std::string("format ") + name;
+		double seconds;
+		std::vector<unsigned char> image = drawFormat<Format>(label.c_str(), shader, vertices, indices,
+			DRAWS, options, context, scene, seconds);
+		printf("  vertices     %d bytes each, %.2f MB for %zu\n", Format::stride,
+			vertices.size() * Format::stride / (1024.0 * 1024.0), vertices.size());
+		return image;
+	}
+}
+
+// the same lit grid as plain floats (what MeshVertex uses), with its colors and
+// uvs packed into normalized bytes and half floats, and with the normals packed
+// into 10_10_10_2 as well. all three go through mesh.vert and format.frag, which
+// use the color, uv and normal alike, so only the vertex fetch changes. reports
+// the memory each takes and how far each packed render is from the float one
+void runFormatBench(const BenchOptions &options, HeadlessContext &context, Scene &scene) {
+	// the scene's texture, waited for like the window would
+	waitForScene(context, scene);
+	Shader shader("mesh.vert", "format.frag");
+	shader.Set("tex0", 0);
+
+	std::vector<MeshVertex::Vertex> plain = gridVertices<MeshVertex>(CELLS, [](float u, float v) {
+		RipplePoint point = ripple(u, v, EXTENT);
+		return MeshVertex::Make(point.position, point.color, point.uv, point.normal);
+	});
+	std::vector<PackedColorVertex::Vertex> packedColor = gridVertices<PackedColorVertex>(CELLS, [](float u, float v) {
+		RipplePoint point = ripple(u, v, EXTENT);
+		return PackedColorVertex::Make(point.position, Color4ub::Pack(point.color.r, point.color.g, point.color.b),
+			UV2h::Pack(point.uv.u, point.uv.v), point.normal);
+	});
+	std::vector<PackedNormalVertex::Vertex> packedNormal = gridVertices<PackedNormalVertex>(CELLS, [](float u, float v) {
+		RipplePoint point = ripple(u, v, EXTENT);
+		return PackedNormalVertex::Make(point.position, Color4ub::Pack(point.color.r, point.color.g, point.color.b),
+			UV2h::Pack(point.uv.u, point.uv.v), Normal10_10_10_2::Pack(point.normal.x, point.normal.y, point.normal.z));
+	});
+	std::vector<GLuint> indices = gridIndices(CELLS);
+
+	std::vector<unsigned char> plainImage = run<MeshVertex>("float", shader, plain, indices, options, context, scene);
+	std::vector<unsigned char> colorImage = run<PackedColorVertex>("packed color", shader, packedColor, indices,
+		options, context, scene);
+	std::vector<unsigned char> normalImage = run<PackedNormalVertex>("packed normal", shader, packedNormal, indices,
+		options, context, scene);
+	printf("float against packed color:\n");
+	printImageDifference(plainImage, colorImage);
+	printf("float against packed normal:\n");
+	printImageDifference(plainImage, normalImage);
+}
@@ -0,0 +1,88 @@
+#include "HeadlessContext.h"
+#include <EGL/eglext.h>
+#include "GLExtensions.h"
+#include <iostream>
+
+bool HeadlessContext::Create(int w, int h) {
+	width = w;
+	height = h;
+
+	// surfaceless is a Mesa platform, so go through the EXT entry point for it
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay != NULL) {
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	}
+	if (display == EGL_NO_DISPLAY) {
+		std::cout << "Failed to get a surfaceless EGL display" << std::endl;
+		return false;
+	}
+
+	EGLint major, minor;
+	if (!eglInitialize(display, &major, &minor)) {
+		std::cout << "Failed to initialize EGL: 0x" << std::hex << eglGetError() << std::dec << std::endl;
+		return false;
+	}
+	if (!eglBindAPI(EGL_OPENGL_API)) {
+		std::cout << "EGL display has no desktop OpenGL" << std::endl;
+		return false;
+	}
+
+	// same version and profile main.cpp asks GLFW for
+	const EGLint contextAttribs[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 3,
+		EGL_CONTEXT_MINOR_VERSION, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+	// no config and no surface, so the display needs both of these
+	context = eglCreateContext(display, (EGLConfig)0, EGL_NO_CONTEXT, contextAttribs);
+	if (context == EGL_NO_CONTEXT) {
+		std::cout << "Failed to create EGL context: 0x" << std::hex << eglGetError() << std::dec << std::endl;
+		return false;
+	}
+	if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+		std::cout << "Failed to make EGL context current" << std::endl;
+		return false;
+	}
+
+	// load GLAD through EGL rather than libGL directly
+	if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+		std::cout << "Failed to load GL functions" << std::endl;
+		return false;
+	}
+	GLExtensions::Load((GLADloadproc)eglGetProcAddress);
+
+	// there's no default framebuffer without a surface, so make one
+	glGenRenderbuffers(1, &colorbuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, colorbuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorbuffer);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		std::cout << "Offscreen framebuffer is incomplete" << std::endl;
+		return false;
+	}
+
+	glViewport(0, 0, width, height);
+	return true;
+}
+
+void HeadlessContext::Present() {
+	glFinish();
+}
+
+void HeadlessContext::Delete() {
+	if (context != EGL_NO_CONTEXT) {
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteRenderbuffers(1, &colorbuffer);
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		eglDestroyContext(display, context);
+		context = EGL_NO_CONTEXT;
+	}
+	if (display != EGL_NO_DISPLAY) {
+		eglTerminate(display);
+		display = EGL_NO_DISPLAY;
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <EGL/egl.h>
+
+// an offscreen GL 3.3 core context on EGL's surfaceless platform (Mesa llvmpipe
+// works fine), rendering into a framebuffer object instead of a window
+class HeadlessContext {
+public:
+	EGLDisplay display = EGL_NO_DISPLAY;
+	EGLContext context = EGL_NO_CONTEXT;
+	GLuint framebuffer = 0;
+	GLuint colorbuffer = 0;
+	int width = 0;
+	int height = 0;
+
+	// makes the context current, loads glad and binds the framebuffer
+	// prints why and returns false if any of that fails
+	bool Create(int width, int height);
+	// stands in for a buffer swap: waits for the frame to actually finish
+	void Present();
+	void Delete();
+};
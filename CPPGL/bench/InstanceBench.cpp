@@ -0,0 +1,109 @@
+#include "Bench.h"
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <string>
+#include "Scene.h"
+#include "VertexFormat.h"
+
+namespace {
+	// one instance in the per-instance buffer, 84 bytes
+	struct InstanceData {
+		GLfloat transform[16];
+		GLubyte tint[4];
+		GLfloat uvRect[4];
+	};
+
+	// small quads scattered over the view in clip space, column major
+	std::vector<InstanceData> scatter(int count, const BenchOptions &options) {
+		std::mt19937 random(1234);
+		std::uniform_real_distribution<GLfloat> across(-1.0f, 1.0f);
+		// a few pixels wide, so fill rate stays out of the way
+		std::uniform_real_distribution<GLfloat> size(2.0f, 8.0f);
+		std::uniform_int_distribution<int> tint(128, 255);
+		std::uniform_int_distribution<int> cell(0, 1);
+		std::vector<InstanceData> instances(count);
+		for (InstanceData &instance : instances) {
+			GLfloat pixels = size(random);
+			GLfloat sx = pixels * 2.0f / options.width;
+			GLfloat sy = pixels * 2.0f / options.height;
+			GLfloat transform[16] = {
+				sx, 0.0f, 0.0f, 0.0f,
+				0.0f, sy, 0.0f, 0.0f,
+				0.0f, 0.0f, 1.0f, 0.0f,
+				across(random), across(random), 0.0f, 1.0f
+			};
+			std::copy(transform, transform + 16, instance.transform);
+			for (int i = 0; i < 3; i++) {
+				instance.tint[i] = (GLubyte)tint(random);
+			}
+			instance.tint[3] = 255;
+			// one quarter of the texture each, so the uv rect actually does something
+			GLfloat u = cell(random) * 0.5f, v = cell(random) * 0.5f;
+			instance.uvRect[0] = u;
+			instance.uvRect[1] = v;
+			instance.uvRect[2] = u + 0.5f;
+			instance.uvRect[3] = v + 0.5f;
+		}
+		return instances;
+	}
+}
+
+// the scene's quad drawn count times, once with glDrawElementsInstanced and
+// a per-instance buffer, once with a uniform update and a draw per object
+void runInstanceBench(const BenchOptions &options, HeadlessContext &context, Scene &scene) {
+	Shader instancedShader("instanced.vert", "sprite.frag");
+	Shader objectShader("object.vert", "sprite.frag");
+	UniformHandle transformUniform = objectShader.Uniform("transform");
+	UniformHandle tintUniform = objectShader.Uniform("tint");
+	UniformHandle uvRectUniform = objectShader.Uniform("uvRect");
+	instancedShader.Set("tex0", 0);
+	objectShader.Set("tex0", 0);
+
+	for (int count : options.instances) {
+		std::vector<InstanceData> instances = scatter(count, options);
+
+		// the instanced VAO reads the quad from the scene's buffers and the
+		// rest from its own instance buffer
+		VAO instancedVAO;
+		instancedVAO.Bind();
+		VBO instanceVBO(instances.data(), instances.size() * sizeof(InstanceData));
+		scene.ebo1.Bind();
+		instancedVAO.LinkAttrib(scene.vbo1, 0, 3, GL_FLOAT, QuadVertex::stride, (void*)QuadVertex::Offset<0>());
+		instancedVAO.LinkAttrib(scene.vbo1, 2, 2, GL_FLOAT, QuadVertex::stride, (void*)QuadVertex::Offset<2>());
+		GLsizei stride = sizeof(InstanceData);
+		instancedVAO.LinkMatrixAttrib(instanceVBO, 3, 4, 4, stride, (void*)offsetof(InstanceData, transform));
+		instancedVAO.LinkInstanceAttrib(instanceVBO, 7, 4, GL_UNSIGNED_BYTE, stride,
+			(void*)offsetof(InstanceData, tint), 1, GL_TRUE);
+		instancedVAO.LinkInstanceAttrib(instanceVBO, 8, 4, GL_FLOAT, stride, (void*)offsetof(InstanceData, uvRect));
+		instancedVAO.Unbind();
+		instanceVBO.Unbind();
+
+		std::string name = "instanced " + std::to_string(count);
+		runFrames(name.c_str(), options, context, [&]() {
+			glClearColor(0.07f, 0.13f, 0.17f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT);
+			instancedShader.Activate();
+			scene.texture.Bind(0);
+			instancedVAO.Bind();
+			glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, count);
+		});
+
+		name = "per-object " + std::to_string(count);
+		runFrames(name.c_str(), options, context, [&]() {
+			glClearColor(0.07f, 0.13f, 0.17f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT);
+			objectShader.Activate();
+			scene.texture.Bind(0);
+			scene.vao1.Bind();
+			for (const InstanceData &instance : instances) {
+				objectShader.SetMatrix4(transformUniform, instance.transform);
+				objectShader.Set(tintUniform, instance.tint[0] / 255.0f, instance.tint[1] / 255.0f,
+					instance.tint[2] / 255.0f, instance.tint[3] / 255.0f);
+				objectShader.Set(uvRectUniform, instance.uvRect[0], instance.uvRect[1],
+					instance.uvRect[2], instance.uvRect[3]);
+				glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+			}
+		});
+	}
+}
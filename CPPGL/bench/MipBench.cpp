@@ -0,0 +1,65 @@
+#include "Bench.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "MipGenerator.h"
+#include "Scene.h"
+#include "Texture.h"
+
+// a full mip chain for a 4096x4096 image on the cpu, with each filter on each
+// code path this cpu can run, against the scalar path and against glGenerateMipmap
+void runMipBench(const BenchOptions &, HeadlessContext &, Scene &) {
+	const int size = 4096;
+	// smooth gradients with a hard edged, half transparent pattern over them
+	std::vector<unsigned char> pixels((size_t)size * size * 4);
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			unsigned char *pixel = &pixels[((size_t)y * size + x) * 4];
+			bool stripe = ((x / 7) ^ (y / 11)) & 1;
+			pixel[0] = (unsigned char)(x * 255 / size);
+			pixel[1] = (unsigned char)(y * 255 / size);
+			pixel[2] = stripe ? 255 : 40;
+			pixel[3] = stripe ? 255 : (unsigned char)((x + y) & 255);
+		}
+	}
+	printf("[mips] %dx%d, cpu has %s\n", size, size, MipGenerator::PathName(MipGenerator::Detect()));
+
+	for (MipGenerator::Filter filter : { MipGenerator::BOX, MipGenerator::KAISER }) {
+		MipGenerator::Options mipOptions;
+		mipOptions.filter = filter;
+		std::vector<MipGenerator::Level> scalar;
+		double scalarMs = 0.0;
+		for (MipGenerator::Path path : { MipGenerator::SCALAR, MipGenerator::SSE2, MipGenerator::AVX2 }) {
+			if (path > MipGenerator::Detect()) {
+				continue;
+			}
+			mipOptions.path = path;
+			auto start = std::chrono::steady_clock::now();
+			std::vector<MipGenerator::Level> levels = MipGenerator::Generate(pixels.data(), size, size, mipOptions);
+			double ms = millisecondsSince(start);
+			if (path == MipGenerator::SCALAR) {
+				scalar.swap(levels);
+				scalarMs = ms;
+				printf("  %-6s %-6s  %8.2f ms\n", filter == MipGenerator::BOX ? "box" : "kaiser",
+					MipGenerator::PathName(path), ms);
+				continue;
+			}
+			bool same = levels.size() == scalar.size();
+			for (size_t i = 0; same && i < levels.size(); i++) {
+				same = levels[i].pixels == scalar[i].pixels;
+			}
+			printf("  %-6s %-6s  %8.2f ms  %.2fx scalar, %s\n", filter == MipGenerator::BOX ? "box" : "kaiser",
+				MipGenerator::PathName(path), ms, scalarMs / ms, same ? "same pixels" : "DIFFERENT PIXELS");
+		}
+	}
+
+	// the driver's chain: gamma-unaware box filtering, on the GL thread
+	Texture texture(size, size, GL_LINEAR, GL_CLAMP_TO_EDGE, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	glFinish();
+	auto start = std::chrono::steady_clock::now();
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+	texture.GenerateMipmaps();
+	glFinish();
+	printf("  glGenerateMipmap  %8.2f ms on the GL thread\n", millisecondsSince(start));
+}
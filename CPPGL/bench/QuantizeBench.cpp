@@ -0,0 +1,63 @@
+#include "Bench.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Scene.h"
+#include "ShaderVariants.h"
+#include "VertexQuantizer.h"
+
+namespace {
+	// cells per side of the mesh, so (CELLS + 1)^2 vertices
+	const int CELLS = 256;
+	// small on screen and drawn twice, so fetching vertices costs more than the pixels
+	const int DRAWS = 2;
+	const float EXTENT = 0.2f;
+
+	// one mesh in one format, reporting how many vertex bytes a second it went through
+	template<typename Format>
+	std::vector<unsigned char> run(const char *name, Shader &shader, const std::vector<typename Format::Vertex> &vertices,
+		const std::vector<GLuint> &indices, const BenchOptions &options, HeadlessContext &context, Scene &scene)
+	{
+		std::string label = std::string("quantize ") + name;
+		double seconds;
+		std::vector<unsigned char> image = drawFormat<Format>(label.c_str(), shader, vertices, indices, DRAWS,
+			options, context, scene, seconds);
+		// each vertex fetched at least once a draw, the post-transform cache hides the rest
+		double bytesPerFrame = (double)vertices.size() * Format::stride * DRAWS;
+		printf("  vertices     %d bytes each, %.2f MB/frame fetched, %.2f GB/s\n", Format::stride,
+			bytesPerFrame / (1024.0 * 1024.0), bytesPerFrame * options.frames / seconds / 1e9);
+		return image;
+	}
+}
+
+// a 66k vertex mesh drawn from full precision vertices and from the same mesh
+// put through VertexQuantizer, with the error the quantizing introduced, the
+// vertex bandwidth each one needs, and how different the two renders come out
+void runQuantizeBench(const BenchOptions &options, HeadlessContext &context, Scene &scene) {
+	waitForScene(context, scene);
+
+	std::vector<MeshVertex::Vertex> full = gridVertices<MeshVertex>(CELLS, [](float u, float v) {
+		RipplePoint point = ripple(u, v, EXTENT);
+		return MeshVertex::Make(point.position, point.color, point.uv, point.normal);
+	});
+	VertexQuantizer::Bounds bounds = VertexQuantizer::Measure(full);
+	VertexQuantizer::Report report;
+	std::vector<QuantizedMeshVertex::Vertex> quantized = VertexQuantizer::Quantize(full, bounds, &report);
+	VertexQuantizer::PrintReport(report);
+	std::vector<GLuint> indices = gridIndices(CELLS);
+
+	ShaderVariants mesh("mesh.vert", "mesh.frag", { "QUANTIZED" });
+	Shader &fullShader = mesh.Get(0);
+	Shader &quantizedShader = mesh.Get(mesh.Bit("QUANTIZED"));
+	fullShader.Set("tex0", 0);
+	quantizedShader.Set("tex0", 0);
+	quantizedShader.Set("boundsMin", bounds.min[0], bounds.min[1], bounds.min[2]);
+	quantizedShader.Set("boundsExtent", bounds.extent[0], bounds.extent[1], bounds.extent[2]);
+
+	std::vector<unsigned char> fullImage = run<MeshVertex>("full", fullShader, full, indices, options, context, scene);
+	std::vector<unsigned char> quantizedImage = run<QuantizedMeshVertex>("packed", quantizedShader, quantized,
+		indices, options, context, scene);
+	// the texture is nearest filtered pixel art, so a position a hair off can flip
+	// a texel where two meet. the mean says more about the whole image than the max
+	printImageDifference(fullImage, quantizedImage);
+}
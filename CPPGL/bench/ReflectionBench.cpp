@@ -0,0 +1,62 @@
+#include "Bench.h"
+#include <chrono>
+#include <cstdio>
+#include "Scene.h"
+#include "VertexFormat.h"
+
+// what reflecting a program at link time buys: a layout matched by name and
+// validated once at load, and draws that use the tables from the reflection
+// instead of asking GL for locations every time like code that doesn't keep them
+void runReflectionBench(const BenchOptions &options, HeadlessContext &context, Scene &scene) {
+	// the quad covers a lot of the view, keep the draw count low enough for software GL
+	const int draws = 200;
+	Shader shader("default.vert", "default.frag");
+	printf("[reflection] default.vert + default.frag: %zu attributes, %zu uniforms, %zu samplers, %zu blocks\n",
+		shader.Attributes().size(), shader.Uniforms().size(), shader.Samplers().size(), shader.Blocks().size());
+
+	// the scene's quad linked by name rather than location 0/1/2
+	VertexLayout layout = QuadVertex::Layout();
+	VAO matched;
+	auto start = std::chrono::steady_clock::now();
+	bool linked = matched.Link(shader, scene.vbo1, layout);
+	double linkMs = millisecondsSince(start);
+	scene.ebo1.Bind();
+	matched.Unbind();
+	printf("  link         %s in %.3f ms\n", linked ? "matched and valid" : "DIDN'T MATCH", linkMs);
+
+	// and one that forgets the texcoords, which Validate should catch before a frame is drawn
+	VertexLayout broken = layout;
+	broken.attributes.pop_back();
+	VAO incomplete;
+	bool caught = !incomplete.Link(shader, scene.vbo1, broken);
+	incomplete.Unbind();
+	printf("  missing uv   %s\n", caught ? "caught at load time" : "NOT CAUGHT");
+
+	// every draw looks up its inputs by name, like there was no reflection
+	runFrames("reflection queried", options, context, [&]() {
+		glClear(GL_COLOR_BUFFER_BIT);
+		shader.Activate();
+		scene.texture.Bind(0);
+		matched.Bind();
+		for (int i = 0; i < draws; i++) {
+			GLint texture = glGetUniformLocation(shader.ID, "tex0");
+			glUniform1i(texture, 0);
+			GLuint frame = glGetUniformBlockIndex(shader.ID, "Frame");
+			glUniformBlockBinding(shader.ID, frame, UniformBlocks::FRAME);
+			glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		}
+	});
+
+	// the sampler table and block bindings were settled when the program linked
+	const SamplerInfo &sampler = shader.Samplers()[0];
+	runFrames("reflection tables", options, context, [&]() {
+		glClear(GL_COLOR_BUFFER_BIT);
+		shader.Activate();
+		scene.texture.Bind(0);
+		matched.Bind();
+		for (int i = 0; i < draws; i++) {
+			shader.Set(sampler.uniform, 0);
+			glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		}
+	});
+}
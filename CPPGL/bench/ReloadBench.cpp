@@ -0,0 +1,92 @@
+#include "Bench.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "Scene.h"
+#include "ShaderReloader.h"
+#include "shaderClass.h"
+
+static void writeFile(const std::string &path, const std::string &contents) {
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	out << contents;
+}
+
+// runs the reloader's Update like a frame loop would, until it has swapped in or
+// rejected one more program than before, or a few seconds have gone by
+static bool waitForReload(ShaderReloader &reloader, HeadlessContext &context) {
+	ShaderReloader::Stats before = reloader.GetStats();
+	auto start = std::chrono::steady_clock::now();
+	while (millisecondsSince(start) < 5000.0) {
+		reloader.Update();
+		ShaderReloader::Stats now = reloader.GetStats();
+		if (now.reloads != before.reloads || now.failures != before.failures) {
+			return true;
+		}
+		context.Present();
+	}
+	return false;
+}
+
+// how long an edited shader takes to show up with hot reloading, from the file
+// being saved to the new program being swapped in, against starting a fresh
+// Scene. also checks a uniform set before the edit survives it, and that a
+// broken edit leaves the old program drawing
+void runReloadBench(const BenchOptions &, HeadlessContext &context, Scene &) {
+	const std::filesystem::path directory = "reload_bench";
+	const std::string vertexFile = (directory / "default.vert").string();
+	const std::string fragmentFile = (directory / "default.frag").string();
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	std::string vertex = get_file_contents("default.vert");
+	std::string fragment = get_file_contents("default.frag");
+	writeFile(vertexFile, vertex);
+	writeFile(fragmentFile, fragment);
+	// default.vert #includes it from its own directory
+	writeFile((directory / "uniform_blocks.glsl").string(), get_file_contents("uniform_blocks.glsl"));
+
+	auto start = std::chrono::steady_clock::now();
+	{
+		Scene fresh;
+		while (!(fresh.shaderReady && fresh.texture.Ready())) {
+			fresh.Draw();
+			context.Present();
+		}
+	}
+	printf("[reload] a fresh Scene takes %.2f ms to be ready\n", millisecondsSince(start));
+
+	ShaderReloader reloader;
+	Shader shader(vertexFile.c_str(), fragmentFile.c_str());
+	reloader.Watch(shader, vertexFile, fragmentFile);
+	UniformHandle texture = shader.Uniform("tex0");
+	shader.Set(texture, 3);
+
+	// every edit changes the source, even from one run to the next, so the program
+	// cache can't just hand back a binary it already has
+	const int edits = 10;
+	long long run = (long long)std::chrono::system_clock::now().time_since_epoch().count();
+	double totalMs = 0.0;
+	int reloaded = 0;
+	bool kept = true;
+	for (int i = 0; i < edits; i++) {
+		writeFile(fragmentFile, fragment + "\n// edit " + std::to_string(i) + " of run " + std::to_string(run) + "\n");
+		if (waitForReload(reloader, context) && reloader.GetStats().reloads > (unsigned int)reloaded) {
+			reloaded++;
+			totalMs += reloader.GetStats().lastReloadMs;
+		}
+		GLint value = 0;
+		glGetUniformiv(shader.ID, glGetUniformLocation(shader.ID, "tex0"), &value);
+		kept = kept && value == 3;
+	}
+	printf("  edit         %d of %d reloaded, %.2f ms avg from save to swap, uniforms %s\n", reloaded, edits,
+		reloaded > 0 ? totalMs / reloaded : 0.0, kept ? "kept" : "LOST");
+
+	GLuint before = shader.ID;
+	writeFile(fragmentFile, fragment + "\nthis doesn't compile\n");
+	bool rejected = waitForReload(reloader, context) && reloader.GetStats().failures == 1;
+	printf("  broken edit  %s, %s\n", rejected ? "rejected" : "NOT REJECTED",
+		shader.ID == before && shader.Ready() ? "old program still in use" : "OLD PROGRAM LOST");
+
+	std::filesystem::remove_all(directory, error);
+}
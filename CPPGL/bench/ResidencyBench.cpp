@@ -0,0 +1,58 @@
+#include "Bench.h"
+#include <cstdio>
+#include <vector>
+#include "GLObjects.h"
+#include "Scene.h"
+#include "Texture.h"
+#include "TextureLoader.h"
+#include "TextureResidency.h"
+
+// options.textures copies of the pumpkin under a budget of a third of what they
+// take at full size. each frame binds a window of 64 of them that slides along
+// by 4, so the ones falling out the back go cold and get reduced while the ones
+// coming in at the front reload. prints the residency report every 100 frames
+void runResidencyBench(const BenchOptions &options, HeadlessContext &context, Scene &scene) {
+	const char *file = "pumpkin panic 2 1x.png";
+	const int window = 64;
+	const int step = 4;
+
+	// whatever the scene has resident stays in the budget as it is
+	size_t others = GLObjects::Bytes(GLObjects::TEXTURE) + GLObjects::Bytes(GLObjects::BUFFER);
+	TextureLoader loader(0, options.uploadKB * 1024);
+	std::vector<Texture> textures;
+	textures.reserve(options.textures);
+	for (int i = 0; i < options.textures; i++) {
+		textures.emplace_back(file, loader, GL_NEAREST);
+	}
+	loader.Wait();
+	size_t full = GLObjects::Bytes(GLObjects::TEXTURE) + GLObjects::Bytes(GLObjects::BUFFER) - others;
+	size_t budget = others + full / 3;
+
+	TextureResidency residency(loader, budget);
+	for (Texture &texture : textures) {
+		residency.Manage(texture, file);
+	}
+	printf("[residency] %d textures, %.2f MB at full size, %.2f MB budget\n", options.textures,
+		full / (1024.0 * 1024.0), budget / (1024.0 * 1024.0));
+
+	int frame = 0;
+	runFrames("residency", options, context, [&]() {
+		if (frame == options.warmup) {
+			residency.ResetStats();
+		}
+		int first = frame * step;
+		for (int i = 0; i < window && i < options.textures; i++) {
+			Texture &texture = textures[(first + i) % options.textures];
+			residency.Use(texture);
+			texture.Bind(0);
+		}
+		scene.Draw();
+		loader.Update();
+		residency.Update();
+		if (++frame % 100 == 0) {
+			printf("  frame %4d  ", frame);
+			residency.PrintReport();
+		}
+	});
+	loader.PrintReport();
+}
@@ -0,0 +1,43 @@
+#include "Bench.h"
+#include <cstdio>
+#include <random>
+#include "Scene.h"
+#include "SpriteBatch.h"
+
+// options.sprites pumpkins scattered over the view, all through one SpriteBatch
+void runSpriteBench(const BenchOptions &options, HeadlessContext &context, Scene &scene) {
+	struct Placed {
+		GLfloat x, y, size;
+		GLubyte r, g, b;
+	};
+	// fixed seed so every run draws the same frame
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<GLfloat> across(0.0f, (GLfloat)options.width);
+	std::uniform_real_distribution<GLfloat> down(0.0f, (GLfloat)options.height);
+	// small enough that llvmpipe fill rate doesn't drown out the batching cost
+	std::uniform_real_distribution<GLfloat> size(2.0f, 8.0f);
+	std::uniform_int_distribution<int> tint(128, 255);
+	std::vector<Placed> sprites(options.sprites);
+	for (Placed &sprite : sprites) {
+		sprite = { across(random), down(random), size(random),
+			(GLubyte)tint(random), (GLubyte)tint(random), (GLubyte)tint(random) };
+	}
+
+	Shader spriteShader("sprite.vert", "sprite.frag");
+	SpriteBatch batch(spriteShader);
+	SpriteBatch::Stats stats = {};
+
+	runFrames("sprites", options, context, [&]() {
+		glClearColor(0.07f, 0.13f, 0.17f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		batch.Begin((GLfloat)options.width, (GLfloat)options.height);
+		for (const Placed &sprite : sprites) {
+			batch.Draw(scene.texture.ID, sprite.x, sprite.y, sprite.size, sprite.size,
+				{ 0.0f, 0.0f, 1.0f, 1.0f }, sprite.r, sprite.g, sprite.b);
+		}
+		batch.End();
+		stats = batch.GetStats();
+	});
+	printf("  sprite batch %u sprites in %u draws (%u texture flushes, %u capacity flushes)\n",
+		stats.sprites, stats.draws, stats.textureFlushes, stats.capacityFlushes);
+}
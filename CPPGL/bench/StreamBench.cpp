@@ -0,0 +1,45 @@
+#include "Bench.h"
+#include <cstdio>
+#include <string>
+#include "Scene.h"
+#include "SpriteBatch.h"
+
+// pushes options.streamMB of sprite vertices through a SpriteBatch every frame,
+// once per StreamBuffer mode, and reports upload bandwidth and fence stalls.
+// the sprites sit just outside the view so they get clipped and the numbers are
+// about moving bytes rather than llvmpipe filling pixels
+void runStreamBench(const BenchOptions &options, HeadlessContext &context, Scene &scene) {
+	const GLsizei capacity = 16384;
+	int sprites = (int)(options.streamMB * 1024.0 * 1024.0 / (4 * sizeof(SpriteVertex)));
+	Shader spriteShader("sprite.vert", "sprite.frag");
+
+	StreamBuffer::Mode modes[] = { StreamBuffer::PERSISTENT, StreamBuffer::UNSYNCHRONIZED, StreamBuffer::ORPHAN };
+	for (StreamBuffer::Mode mode : modes) {
+		SpriteBatch batch(spriteShader, capacity, mode);
+		if (batch.stream.mode != mode) {
+			printf("[stream %s] not supported here, skipped\n", StreamBuffer::ModeName(mode));
+			continue;
+		}
+
+		std::string name = std::string("stream ") + StreamBuffer::ModeName(mode);
+		int frame = 0;
+		double seconds = runFrames(name.c_str(), options, context, [&]() {
+			// only count the timed frames, not the warmup
+			if (frame++ == options.warmup) {
+				batch.stream.ResetStats();
+			}
+			glClearColor(0.07f, 0.13f, 0.17f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT);
+			batch.Begin((GLfloat)options.width, (GLfloat)options.height);
+			for (int i = 0; i < sprites; i++) {
+				batch.Draw(scene.texture.ID, -16.0f - (i & 255), (GLfloat)(i & 511), 4.0f, 4.0f);
+			}
+			batch.End();
+		});
+
+		StreamBuffer::Stats stats = batch.stream.GetStats();
+		double megabytes = stats.bytesWritten / (1024.0 * 1024.0);
+		printf("  streamed     %.2f MB/frame, %.1f MB/s, %u stalls (%.2f ms waiting), %u region overflows\n",
+			megabytes / options.frames, megabytes / seconds, stats.stalls, stats.stallMs, stats.overflows);
+	}
+}
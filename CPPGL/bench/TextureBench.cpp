@@ -0,0 +1,53 @@
+#include "Bench.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "Scene.h"
+#include "Texture.h"
+#include "TextureLoader.h"
+
+// loads options.textures copies of the pumpkin: first all at once on the GL
+// thread, which is one long frame, then through a TextureLoader while the scene
+// keeps drawing, where no frame should take much longer than the budget allows
+void runTextureBench(const BenchOptions &options, HeadlessContext &context, Scene &scene) {
+	const char *file = "pumpkin panic 2 1x.png";
+
+	auto start = std::chrono::steady_clock::now();
+	{
+		std::vector<Texture> textures;
+		textures.reserve(options.textures);
+		for (int i = 0; i < options.textures; i++) {
+			textures.emplace_back(file);
+		}
+		glFinish();
+		double ms = millisecondsSince(start);
+		printf("[textures blocking] %d textures in %.2f ms on the GL thread\n", options.textures, ms);
+	}
+
+	TextureLoader loader(0, options.uploadKB * 1024);
+	std::vector<Texture> textures;
+	int loadedFrame = -1;
+	int frame = 0;
+	// no warmup, the loading is what's being measured
+	BenchOptions timed = options;
+	timed.warmup = 0;
+	runFrames("textures async", timed, context, [&]() {
+		if (frame == 0) {
+			for (int i = 0; i < options.textures; i++) {
+				// no reserve here on purpose, pending textures get moved as the vector grows
+				textures.emplace_back(file, loader);
+			}
+		}
+		scene.Draw();
+		if (loader.Update() && loadedFrame < 0) {
+			loadedFrame = frame;
+		}
+		frame++;
+	});
+	if (loadedFrame >= 0) {
+		printf("  loaded       all %d by frame %d\n", options.textures, loadedFrame);
+	} else {
+		printf("  loaded       %zu still pending after %d frames\n", loader.Pending(), frame);
+	}
+	loader.PrintReport();
+}
@@ -0,0 +1,109 @@
+#include "Bench.h"
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "Scene.h"
+#include "UBO.h"
+#include "UniformBlocks.h"
+#include "UniformRing.h"
+
+namespace {
+	// a few programs, so consecutive draws keep switching between them like
+	// objects with different materials would
+	const int PROGRAMS = 4;
+
+	// small quads scattered over the view, the same every run
+	std::vector<UniformBlocks::ObjectBlock> scatter(int count, const BenchOptions &options) {
+		std::mt19937 random(1234);
+		std::uniform_real_distribution<GLfloat> across(-1.0f, 1.0f);
+		std::uniform_real_distribution<GLfloat> size(2.0f, 8.0f);
+		std::uniform_real_distribution<GLfloat> tint(0.5f, 1.0f);
+		std::uniform_int_distribution<int> cell(0, 1);
+		std::vector<UniformBlocks::ObjectBlock> objects(count);
+		for (UniformBlocks::ObjectBlock &object : objects) {
+			GLfloat pixels = size(random);
+			object.transform = UniformBlocks::Identity();
+			object.transform.m[0] = pixels * 2.0f / options.width;
+			object.transform.m[5] = pixels * 2.0f / options.height;
+			object.transform.m[12] = across(random);
+			object.transform.m[13] = across(random);
+			object.tint = { tint(random), tint(random), tint(random), 1.0f };
+			GLfloat u = cell(random) * 0.5f, v = cell(random) * 0.5f;
+			object.uvRect = { u, v, u + 0.5f, v + 0.5f };
+		}
+		return objects;
+	}
+}
+
+// the scene's quad drawn once per object, switching program every draw. once with
+// object.vert and its uniforms set one at a time, once with object_ubo.vert where
+// the frame's data is one shared UBO bound once and each object's is a slice of a
+// ring buffer bound with glBindBufferRange
+void runUniformBench(const BenchOptions &options, HeadlessContext &context, Scene &scene) {
+	int count = options.instances.empty() ? 10000 : options.instances[0];
+	std::vector<UniformBlocks::ObjectBlock> objects = scatter(count, options);
+
+	std::vector<Shader> plain;
+	std::vector<Shader> blocks;
+	for (int i = 0; i < PROGRAMS; i++) {
+		plain.emplace_back("object.vert", "sprite.frag");
+		blocks.emplace_back("object_ubo.vert", "sprite.frag");
+		plain.back().Set("tex0", 0);
+		blocks.back().Set("tex0", 0);
+	}
+	UniformHandle transformUniform = plain[0].Uniform("transform");
+	UniformHandle tintUniform = plain[0].Uniform("tint");
+	UniformHandle uvRectUniform = plain[0].Uniform("uvRect");
+
+	auto drawPlain = [&]() {
+		glClearColor(0.07f, 0.13f, 0.17f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		scene.texture.Bind(0);
+		scene.vao1.Bind();
+		for (int i = 0; i < count; i++) {
+			// the same source, so the handles are the same in every program
+			Shader &shader = plain[i % PROGRAMS];
+			const UniformBlocks::ObjectBlock &object = objects[i];
+			shader.SetMatrix4(transformUniform, object.transform.m);
+			shader.Set(tintUniform, object.tint.x, object.tint.y, object.tint.z, object.tint.w);
+			shader.Set(uvRectUniform, object.uvRect.x, object.uvRect.y, object.uvRect.z, object.uvRect.w);
+			glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		}
+	};
+	std::string name = "uniforms " + std::to_string(count);
+	runFrames(name.c_str(), options, context, drawPlain);
+	drawPlain();
+	unsigned long long plainImage = checksum(options);
+
+	UniformBlocks::FrameBlock frame = {};
+	frame.viewProjection = UniformBlocks::Identity();
+	frame.viewport = { (GLfloat)options.width, (GLfloat)options.height };
+	UBO frameUniforms(&frame, sizeof(frame));
+	UniformRing ring(count * ((sizeof(UniformBlocks::ObjectBlock) + 255) / 256 * 256));
+	auto drawBlocks = [&]() {
+		glClearColor(0.07f, 0.13f, 0.17f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		frame.time += 1.0f / 60.0f;
+		frameUniforms.Update(0, &frame, sizeof(frame));
+		frameUniforms.BindBase(UniformBlocks::FRAME);
+		scene.texture.Bind(0);
+		scene.vao1.Bind();
+		for (int i = 0; i < count; i++) {
+			blocks[i % PROGRAMS].Activate();
+			ring.Push(UniformBlocks::OBJECT, objects[i]);
+			glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		}
+		ring.EndFrame();
+	};
+	ring.stream.ResetStats();
+	name = "uniform blocks " + std::to_string(count);
+	runFrames(name.c_str(), options, context, drawBlocks);
+	StreamBuffer::Stats stats = ring.stream.GetStats();
+	drawBlocks();
+	unsigned long long blockImage = checksum(options);
+	printf("  ring         %s, %d byte slices, %.1f KB/frame, %u stalls, %u overflows\n",
+		StreamBuffer::ModeName(ring.stream.mode), (int)ring.Alignment(),
+		stats.bytesWritten / 1024.0 / (options.frames + options.warmup), stats.stalls, stats.overflows);
+	printf("  image        %s\n", plainImage == blockImage ? "same both ways" : "DIFFERENT");
+}
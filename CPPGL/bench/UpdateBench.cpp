@@ -0,0 +1,36 @@
+#include "Bench.h"
+#include <cstdio>
+#include <vector>
+#include "VBO.h"
+
+// a big dynamic vertex buffer where only a small slice changes each frame:
+// patched in place with Update, versus re-uploading the whole thing
+void runUpdateBench(const BenchOptions &options, HeadlessContext &context, Scene &) {
+	const GLsizeiptr total = 16 * 1024 * 1024;
+	const GLsizeiptr patch = 64 * 1024;
+	std::vector<unsigned char> contents(total, 0x7f);
+
+	// grow it a chunk at a time first, like an editor appending geometry
+	VBO vbo(NULL, 0, GL_DYNAMIC_DRAW);
+	GLsizeiptr lastCapacity = 0;
+	int reallocations = 0;
+	for (GLsizeiptr offset = 0; offset < total; offset += patch) {
+		vbo.Update(offset, contents.data() + offset, patch);
+		if (vbo.capacity != lastCapacity) {
+			reallocations++;
+			lastCapacity = vbo.capacity;
+		}
+	}
+	printf("[updates] appended %lld KB in %lld KB steps, %d reallocations\n",
+		(long long)(total / 1024), (long long)(patch / 1024), reallocations);
+
+	GLintptr offset = 0;
+	runFrames("updates patch", options, context, [&]() {
+		vbo.Update(offset, contents.data() + offset, patch);
+		offset = (offset + patch) % total;
+	});
+	runFrames("updates full", options, context, [&]() {
+		vbo.Bind();
+		glBufferData(GL_ARRAY_BUFFER, total, contents.data(), GL_DYNAMIC_DRAW);
+	});
+}
@@ -0,0 +1,59 @@
+#include "Bench.h"
+#include <cstdio>
+#include <vector>
+#include "Texture.h"
+#include "TextureUploader.h"
+
+// a 1024x1024 texture rewritten every frame like a video, straight from client
+// memory versus staged through a TextureUploader, then a frame of scattered
+// tile updates and a mip level going through the uploader
+void runUploadBench(const BenchOptions &options, HeadlessContext &context, Scene &) {
+	const GLsizei size = 1024;
+	const GLsizei tile = 128;
+	// two frames of pixels to alternate between, so no frame uploads what's already there
+	std::vector<unsigned char> frames[2];
+	for (int f = 0; f < 2; f++) {
+		frames[f].resize((size_t)size * size * 4);
+		for (size_t i = 0; i < frames[f].size(); i++) {
+			frames[f][i] = (unsigned char)(i * (f + 3) >> 4);
+		}
+	}
+
+	Texture video(size, size, GL_LINEAR);
+	int frame = 0;
+	runFrames("upload direct", options, context, [&]() {
+		const std::vector<unsigned char> &pixels = frames[frame++ & 1];
+		video.Bind(0);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	});
+
+	// one whole frame per region, three frames in flight
+	TextureUploader uploader((GLsizeiptr)size * size * 4);
+	frame = 0;
+	runFrames("upload staged", options, context, [&]() {
+		if (frame == options.warmup) {
+			uploader.ResetStats();
+		}
+		uploader.Upload(video, 0, 0, 0, size, size, frames[frame++ & 1].data());
+		uploader.EndFrame();
+	});
+	TextureUploader::Stats stats = uploader.GetStats();
+	StreamBuffer::Stats staging = uploader.stream.GetStats();
+	printf("  staged       %u uploads in %u strips, %.1f MB, %u stalls (%.2f ms waiting)\n",
+		stats.uploads, stats.strips, stats.bytes / (1024.0 * 1024.0), staging.stalls, staging.stallMs);
+
+	// tiles cut out of the middle of the source image, plus the level below the base
+	frame = 0;
+	std::vector<unsigned char> half((size_t)size / 2 * size / 2 * 4, 0x80);
+	runFrames("upload tiles", options, context, [&]() {
+		const std::vector<unsigned char> &pixels = frames[frame++ & 1];
+		GLsizei stride = size * 4;
+		for (int i = 0; i < 16; i++) {
+			GLint x = (i * 7 + frame * 3) % (size / tile) * tile;
+			GLint y = (i * 5 + frame) % (size / tile) * tile;
+			uploader.Upload(video, 0, x, y, tile, tile, pixels.data() + (size_t)y * stride + x * 4, stride);
+		}
+		uploader.Upload(video, 1, 0, 0, size / 2, size / 2, half.data());
+		uploader.EndFrame();
+	});
+}
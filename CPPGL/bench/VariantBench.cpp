@@ -0,0 +1,79 @@
+#include "Bench.h"
+#include <chrono>
+#include <cstdio>
+#include "ProgramCache.h"
+#include "Scene.h"
+#include "ShaderBatch.h"
+#include "ShaderVariants.h"
+#include "shaderClass.h"
+
+// material.vert/.frag has 8 features, so 256 possible programs. a scene only
+// ever uses a handful, so draw the quad with 12 of them picked lazily, then
+// compare with what building all 256 up front costs. the program cache is off
+// for both, so every variant is a real compile
+void runVariantBench(const BenchOptions &options, HeadlessContext &context, Scene &scene) {
+	const std::vector<std::string> features = {
+		"TINT", "TEXTURED", "VERTEX_COLOR", "FOG", "ALPHA_TEST", "GRAYSCALE", "FLIP_Y", "DITHER"
+	};
+	bool cached = ProgramCache::Enabled();
+	ProgramCache::SetEnabled(false);
+
+	ShaderVariants lazy("material.vert", "material.frag", features);
+	const uint32_t textured = lazy.Bit("TEXTURED") | lazy.Bit("FLIP_Y");
+	// the few combinations a scene might actually draw with
+	const uint32_t used[] = {
+		textured, textured | lazy.Bit("TINT"), textured | lazy.Bit("FOG"), textured | lazy.Bit("ALPHA_TEST"),
+		textured | lazy.Bit("TINT") | lazy.Bit("FOG"), textured | lazy.Bit("GRAYSCALE"),
+		textured | lazy.Bit("VERTEX_COLOR"), textured | lazy.Bit("DITHER"), lazy.Bit("VERTEX_COLOR"),
+		lazy.Bit("VERTEX_COLOR") | lazy.Bit("FOG"), textured | lazy.Bit("TINT") | lazy.Bit("ALPHA_TEST"),
+		textured | lazy.Bit("GRAYSCALE") | lazy.Bit("DITHER")
+	};
+	const int usedCount = sizeof(used) / sizeof(used[0]);
+
+	int frame = 0;
+	int failed = 0;
+	// only the time spent in Get, the frames themselves are in the usual report
+	double lazyMs = 0.0;
+	runFrames("variants", options, context, [&]() {
+		glClear(GL_COLOR_BUFFER_BIT);
+		uint32_t mask = used[frame++ % usedCount];
+		auto start = std::chrono::steady_clock::now();
+		Shader &shader = lazy.Get(mask);
+		lazyMs += millisecondsSince(start);
+		if (!shader.Ready()) {
+			failed++;
+			return;
+		}
+		shader.Activate();
+		shader.Set("scale", 0.5f);
+		// without TEXTURED the sampler is compiled out
+		if (mask & lazy.Bit("TEXTURED")) {
+			shader.Set("tex0", 0);
+		}
+		scene.texture.Bind(0);
+		scene.vao1.Bind();
+		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+	});
+	ShaderVariants::Stats stats = lazy.GetStats();
+	printf("  lazy         %u variants built for %u requests, %.2f ms preprocessing, %.2f ms in Get%s\n",
+		stats.compiled, stats.requests, stats.preprocessMs, lazyMs, failed > 0 ? ", SOME FAILED" : "");
+
+	// the same material built every way it could be, on a batch so the driver
+	// can compile them in parallel if it's able to
+	ShaderBatch batch;
+	ShaderVariants eager("material.vert", "material.frag", features, &batch);
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t mask = 0; mask < (1u << features.size()); mask++) {
+		eager.Get(mask);
+	}
+	batch.Wait();
+	double eagerMs = millisecondsSince(start);
+	failed = 0;
+	for (uint32_t mask = 0; mask < (1u << features.size()); mask++) {
+		failed += eager.Get(mask).Ready() ? 0 : 1;
+	}
+	printf("  all up front %zu variants in %.2f ms, %.1fx the lazy Gets%s\n", eager.Compiled(), eagerMs,
+		eagerMs / lazyMs, failed > 0 ? ", SOME FAILED" : "");
+
+	ProgramCache::SetEnabled(cached);
+}
@@ -0,0 +1,160 @@
+// headless frame benchmark: runs the same Scene the window draws, for a fixed
+// number of frames on an offscreen context, and reports throughput
+//
+// usage: cppgl_bench [--frames N] [--warmup N] [--size WxH]
+//                    [--shader-cache DIR | --no-shader-cache]
+//                    [--scenario quad|sprites|instancing|streaming|updates|textures|uploads|atlas|arrays|cooked|compressed|mips|residency|archive|reload|variants|uniforms|reflection|formats|quantize]...
+//                    [--sprites N] [--instances N,N,...] [--stream-mb MB]
+//                    [--textures N] [--upload-kb KB] [--assets N]
+// run it from a directory holding the shaders and the pumpkin png
+// (the cmake build copies them next to the binary)
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "Bench.h"
+#include "GLObjects.h"
+#include "GLStats.h"
+#include "ProgramCache.h"
+#include "Samplers.h"
+#include "Scene.h"
+
+static const char *USAGE =
+	"usage: cppgl_bench [--frames N] [--warmup N] [--size WxH]\n"
+	"                   [--shader-cache DIR | --no-shader-cache]\n"
+	"                   [--scenario quad|sprites|instancing|streaming|updates|textures|uploads|atlas|arrays|cooked|compressed|mips|residency|archive|reload|variants|uniforms|reflection|formats|quantize]...\n"
+	"                   [--sprites N] [--instances N,N,...] [--stream-mb MB]\n"
+	"                   [--textures N] [--upload-kb KB] [--assets N]";
+
+static bool parseOptions(int argc, char **argv, BenchOptions &options) {
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--frames" && hasValue) {
+			options.frames = std::max(1, atoi(argv[++i]));
+		} else if (arg == "--warmup" && hasValue) {
+			options.warmup = std::max(0, atoi(argv[++i]));
+		} else if (arg == "--size" && hasValue) {
+			if (sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2) {
+				return false;
+			}
+		} else if (arg == "--shader-cache" && hasValue) {
+			options.shaderCache = argv[++i];
+		} else if (arg == "--no-shader-cache") {
+			options.useShaderCache = false;
+		} else if (arg == "--scenario" && hasValue) {
+			options.scenarios.push_back(argv[++i]);
+		} else if (arg == "--sprites" && hasValue) {
+			options.sprites = std::max(1, atoi(argv[++i]));
+		} else if (arg == "--instances" && hasValue) {
+			options.instances.clear();
+			std::stringstream list(argv[++i]);
+			std::string count;
+			while (std::getline(list, count, ',')) {
+				options.instances.push_back(std::max(1, atoi(count.c_str())));
+			}
+		} else if (arg == "--stream-mb" && hasValue) {
+			options.streamMB = std::max(0.01, atof(argv[++i]));
+		} else if (arg == "--textures" && hasValue) {
+			options.textures = std::max(1, atoi(argv[++i]));
+		} else if (arg == "--upload-kb" && hasValue) {
+			options.uploadKB = (size_t)std::max(1, atoi(argv[++i]));
+		} else if (arg == "--assets" && hasValue) {
+			options.assets = std::max(3, atoi(argv[++i]));
+		} else {
+			return false;
+		}
+	}
+	if (options.scenarios.empty()) {
+		options.scenarios.push_back("quad");
+	}
+	return true;
+}
+
+int main(int argc, char **argv) {
+	BenchOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		std::cout << USAGE << std::endl;
+		return 2;
+	}
+
+	HeadlessContext context;
+	if (!context.Create(options.width, options.height)) {
+		context.Delete();
+		return -1;
+	}
+	printf("renderer: %s | %s | %s\n",
+		glGetString(GL_VENDOR), glGetString(GL_RENDERER), glGetString(GL_VERSION));
+
+	GLStats::InstallCounters();
+	ProgramCache::SetDirectory(options.shaderCache);
+	if (!options.useShaderCache) {
+		ProgramCache::SetEnabled(false);
+	}
+
+	int result = 0;
+	{
+		Scene scene;
+		for (const std::string &scenario : options.scenarios) {
+			// the rest draw with the scene's texture, so it has to be loaded first
+			if (scenario != "quad") {
+				scene.textureLoader.Wait();
+			}
+			if (scenario == "quad") {
+				// the scene's shader compiles in the background, warmup frames draw the fallback
+				runFrames("quad", options, context, [&]() { scene.Draw(); });
+			} else if (scenario == "sprites") {
+				runSpriteBench(options, context, scene);
+			} else if (scenario == "instancing") {
+				runInstanceBench(options, context, scene);
+			} else if (scenario == "streaming") {
+				runStreamBench(options, context, scene);
+			} else if (scenario == "updates") {
+				runUpdateBench(options, context, scene);
+			} else if (scenario == "textures") {
+				runTextureBench(options, context, scene);
+			} else if (scenario == "uploads") {
+				runUploadBench(options, context, scene);
+			} else if (scenario == "atlas") {
+				runAtlasBench(options, context, scene);
+			} else if (scenario == "arrays") {
+				runArrayBench(options, context, scene);
+			} else if (scenario == "cooked") {
+				runCookedBench(options, context, scene);
+			} else if (scenario == "compressed") {
+				runCompressedBench(options, context, scene);
+			} else if (scenario == "mips") {
+				runMipBench(options, context, scene);
+			} else if (scenario == "residency") {
+				runResidencyBench(options, context, scene);
+			} else if (scenario == "archive") {
+				runArchiveBench(options, context, scene);
+			} else if (scenario == "reload") {
+				runReloadBench(options, context, scene);
+			} else if (scenario == "variants") {
+				runVariantBench(options, context, scene);
+			} else if (scenario == "uniforms") {
+				runUniformBench(options, context, scene);
+			} else if (scenario == "reflection") {
+				runReflectionBench(options, context, scene);
+			} else if (scenario == "formats") {
+				runFormatBench(options, context, scene);
+			} else if (scenario == "quantize") {
+				runQuantizeBench(options, context, scene);
+			} else {
+				std::cout << "unknown scenario " << scenario << "\n" << USAGE << std::endl;
+				result = 2;
+				break;
+			}
+		}
+		ProgramCache::PrintReport();
+	}
+
+	// everything but the shared samplers should have cleaned itself up by now
+	Samplers::Clear();
+	GLObjects::ReportLeaks();
+	context.Delete();
+	return result;
+}
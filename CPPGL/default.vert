@@ -1,4 +1,5 @@
 #version 330 core
+#include "uniform_blocks.glsl"
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aCol;
 layout (location = 2) in vec2 aTex;
@@ -8,12 +9,11 @@ out vec3 color;
 out vec2 texcoord;
 
 // a uniform is something you can access anywhere (?)
-// never declare uniforms if you don't use them, because they'll be deleted automatically by OpenGL
-// and that will cause errors
-uniform float scale;
+// scale lives in the Frame block from uniform_blocks.glsl, which gets uploaded
+// once a frame and shared by every program instead of set on each one
 
 void main() {
-	gl_Position = vec4(aPos.x + aPos.x*scale, aPos.y + aPos.y*scale, aPos.z + aPos.z*scale, 1.0);
+	gl_Position = vec4(aPos.x + aPos.x*frame.scale, aPos.y + aPos.y*frame.scale, aPos.z + aPos.z*frame.scale, 1.0);
 	color = aCol;
 	texcoord = aTex;
 }
\ No newline at end of file
@@ -0,0 +1,16 @@
+#version 330 core
+// mesh.frag for the format bench: the same lit vertex color, but only half
+// textured, so the color and normal still show where the texture is black
+out vec4 FragColor;
+
+in vec3 color;
+in vec2 texcoord;
+in vec3 normal;
+
+uniform sampler2D tex0;
+
+void main() {
+	float light = 0.3 + 0.7 * max(dot(normalize(normal), normalize(vec3(0.3, 0.5, 0.8))), 0.0);
+	vec4 texel = texture(tex0, vec2(texcoord.s, 1.0-texcoord.t));
+	FragColor = mix(vec4(1.0), texel, 0.5) * vec4(color * light, 1.0);
+}
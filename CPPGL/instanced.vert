@@ -0,0 +1,18 @@
+#version 330 core
+// the quad itself, same layout as default.vert
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aCol;
+layout (location = 2) in vec2 aTex;
+// per instance: a mat4 takes locations 3 to 6, then the tint and which part of the texture to show
+layout (location = 3) in mat4 aTransform;
+layout (location = 7) in vec4 aTint;
+layout (location = 8) in vec4 aUVRect;
+
+out vec4 color;
+out vec2 texcoord;
+
+void main() {
+	gl_Position = aTransform * vec4(aPos, 1.0);
+	color = aTint;
+	texcoord = mix(aUVRect.xy, aUVRect.zw, aTex);
+}
\ No newline at end of file
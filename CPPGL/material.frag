@@ -0,0 +1,36 @@
+#version 330 core
+#include "material_common.glsl"
+out vec4 FragColor;
+
+in MATERIAL_VARYINGS
+
+uniform sampler2D tex0;
+uniform vec4 tint;
+uniform vec4 fogColor;
+uniform float alphaCutoff;
+
+void main() {
+	vec4 result = vec4(color, 1.0);
+#ifdef TEXTURED
+	result *= texture(tex0, texcoord);
+#endif
+#ifdef TINT
+	result *= tint;
+#endif
+#ifdef ALPHA_TEST
+	if (result.a < alphaCutoff) {
+		discard;
+	}
+#endif
+#ifdef GRAYSCALE
+	result.rgb = vec3(luminance(result.rgb));
+#endif
+#ifdef FOG
+	result.rgb = mix(result.rgb, fogColor.rgb, clamp(depth * fogColor.a, 0.0, 1.0));
+#endif
+#ifdef DITHER
+	// a little ordered noise so gradients don't band
+	result.rgb += (fract(sin(dot(gl_FragCoord.xy, vec2(12.9898, 78.233))) * 43758.5453) - 0.5) / 255.0;
+#endif
+	FragColor = result;
+}
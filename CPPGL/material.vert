@@ -0,0 +1,25 @@
+#version 330 core
+// one source for every material variant, ShaderVariants defines the features
+#include "material_common.glsl"
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aCol;
+layout (location = 2) in vec2 aTex;
+
+out MATERIAL_VARYINGS
+
+uniform float scale;
+
+void main() {
+	gl_Position = vec4(aPos * (1.0 + scale), 1.0);
+#ifdef VERTEX_COLOR
+	color = aCol;
+#else
+	color = vec3(1.0);
+#endif
+#ifdef FLIP_Y
+	texcoord = vec2(aTex.s, 1.0 - aTex.t);
+#else
+	texcoord = aTex;
+#endif
+	depth = gl_Position.z * 0.5 + 0.5;
+}
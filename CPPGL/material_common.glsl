@@ -0,0 +1,12 @@
+#pragma once
+// shared by material.vert and material.frag
+
+// what the vertex stage hands the fragment stage
+#define MATERIAL_VARYINGS \
+	vec3 color; \
+	vec2 texcoord; \
+	float depth;
+
+float luminance(vec3 rgb) {
+	return dot(rgb, vec3(0.2126, 0.7152, 0.0722));
+}
@@ -0,0 +1,14 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 color;
+in vec2 texcoord;
+in vec3 normal;
+
+uniform sampler2D tex0;
+
+void main() {
+	// one light over the viewer's shoulder, plus some ambient so nothing goes black
+	float light = 0.3 + 0.7 * max(dot(normalize(normal), normalize(vec3(0.3, 0.5, 0.8))), 0.0);
+	FragColor = texture(tex0, vec2(texcoord.s, 1.0-texcoord.t)) * vec4(color * light, 1.0);
+}
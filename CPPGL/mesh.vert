@@ -0,0 +1,45 @@
+#version 330 core
+// a lit mesh, either full precision or, with QUANTIZED defined, packed by
+// VertexQuantizer: positions 0..1 across the bounding box and octahedral normals
+#include "uniform_blocks.glsl"
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aCol;
+layout (location = 2) in vec2 aTex;
+#ifdef QUANTIZED
+layout (location = 3) in vec2 aNormal;
+#else
+layout (location = 3) in vec3 aNormal;
+#endif
+
+out vec3 color;
+out vec2 texcoord;
+out vec3 normal;
+
+#ifdef QUANTIZED
+// the bounding box the positions were quantized across, min and size
+uniform vec3 boundsMin;
+uniform vec3 boundsExtent;
+
+// unfolds what VertexQuantizer::EncodeNormal folded, not using sign() since it's 0 at 0
+vec3 decodeNormal(vec2 folded) {
+	vec3 n = vec3(folded, 1.0 - abs(folded.x) - abs(folded.y));
+	if (n.z < 0.0) {
+		vec2 side = vec2(folded.x >= 0.0 ? 1.0 : -1.0, folded.y >= 0.0 ? 1.0 : -1.0);
+		n.xy = (1.0 - abs(folded.yx)) * side;
+	}
+	return normalize(n);
+}
+#endif
+
+void main() {
+#ifdef QUANTIZED
+	vec3 position = boundsMin + aPos * boundsExtent;
+	normal = decodeNormal(aNormal);
+#else
+	vec3 position = aPos;
+	normal = aNormal;
+#endif
+	gl_Position = frame.viewProjection * vec4(position, 1.0);
+	color = aCol;
+	texcoord = aTex;
+}
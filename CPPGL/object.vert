@@ -0,0 +1,18 @@
+#version 330 core
+// instanced.vert with the per-instance inputs as uniforms, one draw per object
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aCol;
+layout (location = 2) in vec2 aTex;
+
+out vec4 color;
+out vec2 texcoord;
+
+uniform mat4 transform;
+uniform vec4 tint;
+uniform vec4 uvRect;
+
+void main() {
+	gl_Position = transform * vec4(aPos, 1.0);
+	color = tint;
+	texcoord = mix(uvRect.xy, uvRect.zw, aTex);
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#version 330 core
+// object.vert with the per-object inputs in the Object block instead of loose
+// uniforms, filled from a UniformRing one draw at a time
+#include "uniform_blocks.glsl"
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aCol;
+layout (location = 2) in vec2 aTex;
+
+out vec4 color;
+out vec2 texcoord;
+
+void main() {
+	gl_Position = frame.viewProjection * object.transform * vec4(aPos, 1.0);
+	color = object.tint;
+	texcoord = mix(object.uvRect.xy, object.uvRect.zw, aTex);
+}
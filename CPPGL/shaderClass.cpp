@@ -1,4 +1,30 @@
 #include "shaderClass.h"
+#include "AssetArchive.h"
+#include "GLExtensions.h"
+#include "GLObjects.h"
+#include "GLState.h"
+#include "ProgramCache.h"
+#include "ShaderBatch.h"
+#include "ShaderPreprocessor.h"
+#include "ShaderReloader.h"
+#include "Timing.h"
+#include "UniformBlocks.h"
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+// the leak report shows programs by the size of their binary, when the driver will tell us
+static void trackProgramSize(GLuint program) {
+#ifdef CPPGL_TRACK_OBJECTS
+	GLint length = 0;
+	if (GLExtensions::ARB_get_program_binary) {
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	}
+	GLObjects::Resized(GLObjects::PROGRAM, program, (size_t)length);
+#else
+	(void)program;
+#endif
+}
 
 std::string get_file_contents(const char *filename) {
 	std::ifstream in(filename, std::ios::binary);
@@ -14,57 +40,606 @@ std::string get_file_contents(const char *filename) {
 	throw(errno);
 }
 
-Shader::Shader(const char *vertexFile, const char *fragmentFile) {
-	std::string vertexCode = get_file_contents(vertexFile);
-	std::string fragmentCode = get_file_contents(fragmentFile);
+std::string get_asset_contents(const AssetArchive &assets, const char *name) {
+	AssetArchive::View view = assets.Find(name);
+	if (view.Found() && view.compression == AssetArchive::NONE) {
+		// straight out of the mapping, no file to open
+		return std::string((const char*)view.data, view.size);
+	}
+	std::vector<unsigned char> bytes;
+	if (view.Found() && assets.Read(name, bytes)) {
+		return std::string(bytes.begin(), bytes.end());
+	}
+	throw(ENOENT);
+}
+
+Shader::Shader()
+	: ID(0), status(PENDING), batch(NULL), reloader(NULL), vertexShader(0), fragmentShader(0), cacheKey(0),
+	loadMs(0.0)
+{
+}
+
+Shader::Shader(const char *vertexFile, const char *fragmentFile) : Shader() {
+	begin(ShaderPreprocessor::Process(vertexFile), ShaderPreprocessor::Process(fragmentFile));
+	if (status == PENDING) {
+		compile();
+		link();
+		finish();
+	}
+}
+
+Shader::Shader(const char *vertexFile, const char *fragmentFile, ShaderBatch &shaderBatch) : Shader() {
+	begin(ShaderPreprocessor::Process(vertexFile), ShaderPreprocessor::Process(fragmentFile));
+	if (status == PENDING) {
+		batch = &shaderBatch;
+		batch->Add(this);
+	}
+}
+
+Shader::Shader(const AssetArchive &assets, const char *vertexName, const char *fragmentName) : Shader() {
+	begin(ShaderPreprocessor::Process(assets, vertexName), ShaderPreprocessor::Process(assets, fragmentName));
+	if (status == PENDING) {
+		compile();
+		link();
+		finish();
+	}
+}
+
+Shader::Shader(const AssetArchive &assets, const char *vertexName, const char *fragmentName, ShaderBatch &shaderBatch)
+	: Shader()
+{
+	begin(ShaderPreprocessor::Process(assets, vertexName), ShaderPreprocessor::Process(assets, fragmentName));
+	if (status == PENDING) {
+		batch = &shaderBatch;
+		batch->Add(this);
+	}
+}
+
+Shader Shader::FromSource(const char *vertexCode, const char *fragmentCode) {
+	Shader shader;
+	shader.begin(vertexCode, fragmentCode);
+	if (shader.status == PENDING) {
+		shader.compile();
+		shader.link();
+		shader.finish();
+	}
+	return shader;
+}
+
+Shader Shader::FromSource(const char *vertexCode, const char *fragmentCode, ShaderBatch &shaderBatch) {
+	Shader shader;
+	shader.begin(vertexCode, fragmentCode);
+	if (shader.status == PENDING) {
+		shader.batch = &shaderBatch;
+		shaderBatch.Add(&shader);
+	}
+	// the move hands the batch the returned Shader's address
+	return shader;
+}
+
+Shader::~Shader() {
+	Delete();
+}
+
+Shader::Shader(Shader &&other) noexcept : Shader() {
+	take(other);
+}
+
+Shader &Shader::operator=(Shader &&other) noexcept {
+	if (this != &other) {
+		Delete();
+		take(other);
+	}
+	return *this;
+}
+
+void Shader::take(Shader &other) {
+	ID = other.ID;
+	status = other.status;
+	batch = other.batch;
+	vertexCode = std::move(other.vertexCode);
+	fragmentCode = std::move(other.fragmentCode);
+	vertexShader = other.vertexShader;
+	fragmentShader = other.fragmentShader;
+	cacheKey = other.cacheKey;
+	loadMs = other.loadMs;
+	uniforms = std::move(other.uniforms);
+	uniformTable = std::move(other.uniformTable);
+	missingUniforms = std::move(other.missingUniforms);
+	attributes = std::move(other.attributes);
+	samplers = std::move(other.samplers);
+	blocks = std::move(other.blocks);
+	// the batch finishes programs through the pointer it was given, point it here now
+	if (batch != NULL) {
+		batch->Replace(&other, this);
+	}
+	reloader = other.reloader;
+	if (reloader != NULL) {
+		reloader->Replace(&other, this);
+	}
+
+	other.ID = 0;
+	other.status = FAILED;
+	other.batch = NULL;
+	other.reloader = NULL;
+	other.vertexShader = 0;
+	other.fragmentShader = 0;
+}
 
+void Shader::begin(std::string vertex, std::string fragment) {
+	auto start = std::chrono::steady_clock::now();
+	ID = glCreateProgram();
+	GLObjects::Created(GLObjects::PROGRAM, ID, 0);
+
+	// a program linked on an earlier run can come straight back from the cache
+	if (ProgramCache::Enabled()) {
+		cacheKey = ProgramCache::Key(vertex, fragment);
+		if (ProgramCache::Load(cacheKey, ID)) {
+			status = READY;
+			reflect();
+			trackProgramSize(ID);
+			ProgramCache::RecordLoad(true, millisecondsSince(start));
+			return;
+		}
+		// the driver only promises to hand the binary back if we ask before linking
+		glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+	vertexCode = std::move(vertex);
+	fragmentCode = std::move(fragment);
+	loadMs = millisecondsSince(start);
+}
+
+void Shader::compile() {
+	auto start = std::chrono::steady_clock::now();
 	const char *vertexSource = vertexCode.c_str();
 	const char *fragmentSource = fragmentCode.c_str();
 
 	// create a shader...it's mapped to an int because it's just stored at a certain position somewhere?
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	vertexShader = glCreateShader(GL_VERTEX_SHADER);
 	// tell the vertex shader to use one string, source code as the shader source, and NULL isn't important
 	glShaderSource(vertexShader, 1, &vertexSource, NULL);
 	glCompileShader(vertexShader);
 
 	// and do the same for the fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
 	glShaderSource(fragmentShader, 1, &fragmentSource, NULL);
 	glCompileShader(fragmentShader);
 
-	ID = glCreateProgram();
+	// the driver has its own copy now
+	vertexCode.clear();
+	vertexCode.shrink_to_fit();
+	fragmentCode.clear();
+	fragmentCode.shrink_to_fit();
+	loadMs += millisecondsSince(start);
+}
+
+void Shader::link() {
+	auto start = std::chrono::steady_clock::now();
 	// after creating the shader program, attach the shaders by reference (&) would dereference them into literal values
 	glAttachShader(ID, vertexShader);
 	glAttachShader(ID, fragmentShader);
 	glLinkProgram(ID);
+	loadMs += millisecondsSince(start);
+}
+
+bool Shader::Poll() {
+	if (status != PENDING || vertexShader == 0 || !GLExtensions::parallel_shader_compile) {
+		return status != PENDING;
+	}
+	GLint done = GL_FALSE;
+	glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &done);
+	if (done == GL_TRUE) {
+		finish();
+	}
+	return done == GL_TRUE;
+}
+
+void Shader::finish() {
+	auto start = std::chrono::steady_clock::now();
+	// status queries are where a compile actually gets waited on, so they all live here
+	bool compiled = compileErrors(vertexShader, "VERTEX");
+	compiled = compileErrors(fragmentShader, "FRAGMENT") && compiled;
+	bool linked = compiled && compileErrors(ID, "PROGRAM");
 
 	// then clean up the old vertex/fragment shader objects
 	glDeleteShader(vertexShader);
 	glDeleteShader(fragmentShader);
+	vertexShader = 0;
+	fragmentShader = 0;
+	batch = NULL;
+
+	if (!linked) {
+		status = FAILED;
+		return;
+	}
+	if (ProgramCache::Enabled()) {
+		ProgramCache::Store(cacheKey, ID);
+	}
+	status = READY;
+	reflect();
+	trackProgramSize(ID);
+	ProgramCache::RecordLoad(false, loadMs + millisecondsSince(start));
 }
 
 void Shader::Activate() {
-	glUseProgram(ID);
+	GLState::UseProgram(ID);
 }
 
 void Shader::Delete() {
-	glDeleteProgram(ID);
+	if (batch != NULL) {
+		batch->Remove(this);
+		batch = NULL;
+	}
+	if (reloader != NULL) {
+		reloader->Forget(this);
+		reloader = NULL;
+	}
+	if (vertexShader != 0) {
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+		vertexShader = 0;
+		fragmentShader = 0;
+	}
+	status = FAILED;
+	if (ID != 0) {
+		glDeleteProgram(ID);
+		GLState::ProgramDeleted(ID);
+		GLObjects::Deleted(GLObjects::PROGRAM, ID);
+		ID = 0;
+	}
 }
 
-void Shader::compileErrors(unsigned int shader, const char *type) {
+bool Shader::compileErrors(unsigned int shader, const char *type) {
 	GLint hasCompiled;
 	char infoLog[1024];
-	if (type != "PROGRAM") {
+	if (strcmp(type, "PROGRAM") != 0) {
 		glGetShaderiv(shader, GL_COMPILE_STATUS, &hasCompiled);
 		if (hasCompiled == GL_FALSE) {
 			glGetShaderInfoLog(shader, 1024, NULL, infoLog);
-			std::cout << "shader compile error: " << type << "\n" << std::endl;
-		} else {
-			glGetProgramiv(shader, GL_LINK_STATUS, &hasCompiled);
-			if (hasCompiled == GL_FALSE) {
-				glGetProgramInfoLog(shader, 1024, NULL, infoLog);
-				std::cout << "shader linking error:" << type << "\n" << infoLog << std::endl;
+			std::cout << "shader compile error: " << type << "\n" << infoLog << std::endl;
+		}
+	} else {
+		glGetProgramiv(shader, GL_LINK_STATUS, &hasCompiled);
+		if (hasCompiled == GL_FALSE) {
+			glGetProgramInfoLog(shader, 1024, NULL, infoLog);
+			std::cout << "shader linking error:" << type << "\n" << infoLog << std::endl;
+		}
+	}
+	return hasCompiled == GL_TRUE;
+}
+
+void Shader::reflect() {
+	reflectUniforms();
+	reflectAttributes();
+	reflectBlocks();
+}
+
+void Shader::reflectUniforms() {
+	GLint count = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+	std::vector<char> nameBuffer(maxNameLength + 1);
+	uniforms.clear();
+	for (GLint i = 0; i < count; i++) {
+		GLsizei length = 0;
+		UniformInfo info = {};
+		glGetActiveUniform(ID, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &info.size, &info.type, nameBuffer.data());
+		std::string name(nameBuffer.data(), length);
+		info.location = glGetUniformLocation(ID, name.c_str());
+		// members of uniform blocks don't have a location, they're set through the block
+		if (info.location < 0) {
+			continue;
+		}
+		// arrays come back as "name[0]", make the bare name find them too
+		size_t bracket = name.find('[');
+		if (bracket != std::string::npos) {
+			name.resize(bracket);
+		}
+		info.name = Names::Intern(name);
+		uniforms.push_back(info);
+	}
+	buildUniformTable();
+	collectSamplers();
+}
+
+void Shader::reflectAttributes() {
+	GLint count = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(ID, GL_ACTIVE_ATTRIBUTES, &count);
+	glGetProgramiv(ID, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxNameLength);
+
+	std::vector<char> nameBuffer(maxNameLength + 1);
+	attributes.clear();
+	for (GLint i = 0; i < count; i++) {
+		GLsizei length = 0;
+		AttributeInfo info = {};
+		glGetActiveAttrib(ID, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &info.size, &info.type, nameBuffer.data());
+		std::string name(nameBuffer.data(), length);
+		info.location = glGetAttribLocation(ID, name.c_str());
+		// gl_VertexID and friends are active too, but nothing feeds them
+		if (info.location < 0) {
+			continue;
+		}
+		info.name = Names::Intern(name);
+		attributes.push_back(info);
+	}
+}
+
+// the texture target a sampler type reads, 0 if it isn't a sampler
+static GLenum samplerTarget(GLenum type) {
+	switch (type) {
+	case GL_SAMPLER_2D:
+	case GL_SAMPLER_2D_SHADOW:
+	case GL_INT_SAMPLER_2D:
+	case GL_UNSIGNED_INT_SAMPLER_2D:
+		return GL_TEXTURE_2D;
+	case GL_SAMPLER_2D_ARRAY:
+	case GL_SAMPLER_2D_ARRAY_SHADOW:
+	case GL_INT_SAMPLER_2D_ARRAY:
+	case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+		return GL_TEXTURE_2D_ARRAY;
+	case GL_SAMPLER_3D:
+	case GL_INT_SAMPLER_3D:
+	case GL_UNSIGNED_INT_SAMPLER_3D:
+		return GL_TEXTURE_3D;
+	case GL_SAMPLER_CUBE:
+	case GL_SAMPLER_CUBE_SHADOW:
+	case GL_INT_SAMPLER_CUBE:
+	case GL_UNSIGNED_INT_SAMPLER_CUBE:
+		return GL_TEXTURE_CUBE_MAP;
+	case GL_SAMPLER_BUFFER:
+	case GL_INT_SAMPLER_BUFFER:
+	case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+		return GL_TEXTURE_BUFFER;
+	default:
+		return 0;
+	}
+}
+
+void Shader::collectSamplers() {
+	samplers.clear();
+	for (size_t i = 0; i < uniforms.size(); i++) {
+		GLenum target = samplerTarget(uniforms[i].type);
+		if (target != 0) {
+			samplers.push_back({ (UniformHandle)i, target });
+		}
+	}
+}
+
+const AttributeInfo *Shader::Attribute(const char *name) const {
+	Names::Id id = Names::Intern(name);
+	for (const AttributeInfo &attribute : attributes) {
+		if (attribute.name == id) {
+			return &attribute;
+		}
+	}
+	return NULL;
+}
+
+void Shader::reflectBlocks() {
+	GLint count = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxNameLength);
+
+	std::vector<char> nameBuffer(maxNameLength + 1);
+	blocks.clear();
+	for (GLint i = 0; i < count; i++) {
+		GLsizei length = 0;
+		glGetActiveUniformBlockName(ID, (GLuint)i, (GLsizei)nameBuffer.size(), &length, nameBuffer.data());
+		std::string name(nameBuffer.data(), length);
+		UniformBlockInfo info = {};
+		info.name = Names::Intern(name);
+		info.index = (GLuint)i;
+		glGetActiveUniformBlockiv(ID, info.index, GL_UNIFORM_BLOCK_DATA_SIZE, &info.size);
+		GLint binding = 0;
+		glGetActiveUniformBlockiv(ID, info.index, GL_UNIFORM_BLOCK_BINDING, &binding);
+		info.binding = (GLuint)binding;
+
+		GLuint registered = 0;
+		GLsizeiptr size = 0;
+		// anything not registered is bound by hand, or left on binding 0
+		if (UniformBlocks::Find(name, registered, size)) {
+			if (info.size != size) {
+				std::cout << "uniform block " << name << " is " << info.size << " bytes in the shader but "
+					<< size << " in C++, check it's layout(std140) and matches its struct" << std::endl;
 			}
+			glUniformBlockBinding(ID, info.index, registered);
+			info.binding = registered;
+		}
+		blocks.push_back(info);
+	}
+}
+
+void Shader::buildUniformTable() {
+	// keep the table at most half full so probes stay short
+	size_t tableSize = 8;
+	while (tableSize < uniforms.size() * 2) {
+		tableSize *= 2;
+	}
+	uniformTable.assign(tableSize, 0);
+	for (size_t i = 0; i < uniforms.size(); i++) {
+		size_t slot = uniforms[i].name & (tableSize - 1);
+		while (uniformTable[slot] != 0) {
+			slot = (slot + 1) & (tableSize - 1);
+		}
+		uniformTable[slot] = (int)i + 1;
+	}
+}
+
+void Shader::uploadValue(const UniformInfo &uniform) {
+	const GLint *ints = (const GLint*)uniform.value;
+	switch (uniform.type) {
+	case GL_FLOAT: glUniform1fv(uniform.location, 1, uniform.value); break;
+	case GL_FLOAT_VEC2: glUniform2fv(uniform.location, 1, uniform.value); break;
+	case GL_FLOAT_VEC3: glUniform3fv(uniform.location, 1, uniform.value); break;
+	case GL_FLOAT_VEC4: glUniform4fv(uniform.location, 1, uniform.value); break;
+	case GL_FLOAT_MAT4: glUniformMatrix4fv(uniform.location, 1, GL_FALSE, uniform.value); break;
+	// everything the int setter can target
+	default: glUniform1i(uniform.location, ints[0]); break;
+	}
+}
+
+void Shader::swapProgram(Shader &next) {
+	std::swap(ID, next.ID);
+	status = READY;
+	// handles are indices into uniforms, so the ones we had keep their places with
+	// the new program's locations, and anything new goes on the end. one that's
+	// gone keeps location -1, which GL quietly ignores
+	std::vector<UniformInfo> merged = uniforms;
+	for (UniformInfo &uniform : merged) {
+		UniformHandle found = next.findUniform(uniform.name);
+		if (found < 0) {
+			uniform.location = -1;
+			uniform.hasValue = false;
+			continue;
 		}
+		const UniformInfo &fresh = next.uniforms[found];
+		// a value of the old type doesn't mean anything to the new one
+		uniform.hasValue = uniform.hasValue && fresh.type == uniform.type;
+		uniform.location = fresh.location;
+		uniform.type = fresh.type;
+		uniform.size = fresh.size;
+	}
+	for (const UniformInfo &fresh : next.uniforms) {
+		if (findUniform(fresh.name) < 0) {
+			merged.push_back(fresh);
+		}
+	}
+	uniforms.swap(merged);
+	buildUniformTable();
+	collectSamplers();
+	// names that were missing might be there now
+	missingUniforms.clear();
+	bool sameInputs = attributes.size() == next.attributes.size();
+	for (size_t i = 0; sameInputs && i < attributes.size(); i++) {
+		sameInputs = attributes[i].name == next.attributes[i].name
+			&& attributes[i].location == next.attributes[i].location && attributes[i].type == next.attributes[i].type;
+	}
+	if (!sameInputs) {
+		// VAOs are linked by location, they don't follow along
+		std::cout << "shader " << ID << " has different vertex inputs now, its VAOs may need linking again" << std::endl;
+	}
+	attributes.swap(next.attributes);
+	blocks.swap(next.blocks);
+
+	Activate();
+	for (const UniformInfo &uniform : uniforms) {
+		if (uniform.hasValue) {
+			uploadValue(uniform);
+		}
+	}
+}
+
+UniformHandle Shader::findUniform(Names::Id name) const {
+	if (uniformTable.empty()) {
+		return -1;
+	}
+	size_t mask = uniformTable.size() - 1;
+	for (size_t slot = name & mask; uniformTable[slot] != 0; slot = (slot + 1) & mask) {
+		int index = uniformTable[slot] - 1;
+		if (uniforms[index].name == name) {
+			return index;
+		}
+	}
+	return -1;
+}
+
+UniformHandle Shader::Uniform(const char *name) {
+	Names::Id id = Names::Intern(name);
+	UniformHandle uniform = findUniform(id);
+	if (uniform < 0) {
+		bool reported = false;
+		for (Names::Id missing : missingUniforms) {
+			reported = reported || missing == id;
+		}
+		if (!reported) {
+			missingUniforms.push_back(id);
+			// unused uniforms get optimized out too, so this isn't always a typo
+			std::cout << "shader " << ID << " has no active uniform \"" << name << "\"" << std::endl;
+		}
+	}
+	return uniform;
+}
+
+// float setters can only target float uniforms, int setters ints, bools and samplers
+static bool setterMatches(GLenum uniformType, GLenum setterType) {
+	// every sampler reflection knows takes its unit as an int
+	if (uniformType == GL_BOOL || samplerTarget(uniformType) != 0) {
+		return setterType == GL_INT;
+	}
+	return uniformType == setterType;
+}
+
+static const char *uniformTypeName(GLenum type) {
+	switch (type) {
+	case GL_FLOAT: return "float";
+	case GL_FLOAT_VEC2: return "vec2";
+	case GL_FLOAT_VEC3: return "vec3";
+	case GL_FLOAT_VEC4: return "vec4";
+	case GL_INT: return "int";
+	case GL_FLOAT_MAT4: return "mat4";
+	default: return "another type";
+	}
+}
+
+bool Shader::needsUpload(UniformHandle uniform, GLenum setterType, const void *value, size_t bytes) {
+	if (uniform < 0 || uniform >= (UniformHandle)uniforms.size()) {
+		return false;
+	}
+	UniformInfo &info = uniforms[uniform];
+	if (!setterMatches(info.type, setterType)) {
+		std::cout << "uniform \"" << Names::Lookup(info.name) << "\" set as " << uniformTypeName(setterType)
+			<< " but declared as " << uniformTypeName(info.type) << std::endl;
+		return false;
+	}
+	if (info.hasValue && memcmp(info.value, value, bytes) == 0) {
+		return false;
+	}
+	memcpy(info.value, value, bytes);
+	info.hasValue = true;
+	// uniforms always go to the program in use
+	Activate();
+	return true;
+}
+
+void Shader::Set(UniformHandle uniform, GLfloat x) {
+	if (needsUpload(uniform, GL_FLOAT, &x, sizeof(x))) {
+		glUniform1f(uniforms[uniform].location, x);
+	}
+}
+
+void Shader::Set(UniformHandle uniform, GLfloat x, GLfloat y) {
+	GLfloat value[] = { x, y };
+	if (needsUpload(uniform, GL_FLOAT_VEC2, value, sizeof(value))) {
+		glUniform2f(uniforms[uniform].location, x, y);
+	}
+}
+
+void Shader::Set(UniformHandle uniform, GLfloat x, GLfloat y, GLfloat z) {
+	GLfloat value[] = { x, y, z };
+	if (needsUpload(uniform, GL_FLOAT_VEC3, value, sizeof(value))) {
+		glUniform3f(uniforms[uniform].location, x, y, z);
+	}
+}
+
+void Shader::Set(UniformHandle uniform, GLfloat x, GLfloat y, GLfloat z, GLfloat w) {
+	GLfloat value[] = { x, y, z, w };
+	if (needsUpload(uniform, GL_FLOAT_VEC4, value, sizeof(value))) {
+		glUniform4f(uniforms[uniform].location, x, y, z, w);
+	}
+}
+
+void Shader::Set(UniformHandle uniform, GLint x) {
+	if (needsUpload(uniform, GL_INT, &x, sizeof(x))) {
+		glUniform1i(uniforms[uniform].location, x);
+	}
+}
+
+void Shader::SetMatrix4(UniformHandle uniform, const GLfloat *matrix) {
+	if (needsUpload(uniform, GL_FLOAT_MAT4, matrix, 16 * sizeof(GLfloat))) {
+		glUniformMatrix4fv(uniforms[uniform].location, 1, GL_FALSE, matrix);
 	}
 }
\ No newline at end of file
@@ -7,18 +7,182 @@
 #include <sstream>
 #include <iostream>
 #include <cerrno>
+#include <vector>
+#include <chrono>
+#include "Names.h"
+
+class AssetArchive;
+class ShaderBatch;
+class ShaderReloader;
 
 std::string get_file_contents(const char *filename);
+// the same for an asset in a mounted archive, decompressed if it has to be
+std::string get_asset_contents(const AssetArchive &assets, const char *name);
+
+// index into a shader's uniform list, -1 when the name didn't resolve
+typedef int UniformHandle;
+
+// one active uniform as reported by glGetActiveUniform, plus the last value we sent
+struct UniformInfo {
+	Names::Id name;
+	GLint location;
+	GLenum type;
+	GLint size; // array length, 1 for plain uniforms
+	bool hasValue;
+	// big enough for a mat4, which is the largest thing the setters send
+	GLfloat value[16];
+};
+
+// an active vertex input, as reported by glGetActiveAttrib
+struct AttributeInfo {
+	Names::Id name;
+	GLint location;
+	// GL_FLOAT_VEC3, GL_INT, GL_FLOAT_MAT4...
+	GLenum type;
+	GLint size; // array length, 1 for plain attributes
+};
+
+// a sampler uniform and the texture target it samples, so binding code can look
+// both up front instead of asking GL on every draw. the unit is its uniform's value
+struct SamplerInfo {
+	UniformHandle uniform;
+	GLenum target;
+};
+
+// an active uniform block and the binding point it reads from
+struct UniformBlockInfo {
+	Names::Id name;
+	GLuint index;
+	GLuint binding;
+	GLint size;
+};
 
+// owns its program: deleted when it goes out of scope, moves hand over the ID
+// (and its place in the batch if it's still compiling, or in a ShaderReloader
+// if it's watched), copies aren't allowed
 class Shader {
 public:
+	enum Status {
+		PENDING, // compiling or linking, don't draw with it yet
+		READY,
+		FAILED // didn't compile or link, the log has already been printed
+	};
+
 	GLuint ID; // its ID on the gpu
+	Status status;
+
+	// compiles and links right away. the files go through ShaderPreprocessor
+	// first, so they can #include others
 	Shader(const char *vertexFile, const char *fragmentFile);
+	// reads the files and queues the compile on batch, the shader stays PENDING
+	// until the batch has been submitted and polled past it
+	Shader(const char *vertexFile, const char *fragmentFile, ShaderBatch &batch);
+	// the same two, reading the sources out of an asset archive instead of files.
+	// their #includes are looked up in the archive too
+	Shader(const AssetArchive &assets, const char *vertexName, const char *fragmentName);
+	Shader(const AssetArchive &assets, const char *vertexName, const char *fragmentName, ShaderBatch &batch);
+	// same as the first constructor but from source text instead of files
+	static Shader FromSource(const char *vertexCode, const char *fragmentCode);
+	// and queued on batch like the second, for source that's been preprocessed already
+	static Shader FromSource(const char *vertexCode, const char *fragmentCode, ShaderBatch &batch);
+	~Shader();
+	Shader(Shader &&other) noexcept;
+	Shader &operator=(Shader &&other) noexcept;
+	Shader(const Shader &) = delete;
+	Shader &operator=(const Shader &) = delete;
+
+	bool Ready() const { return status == READY; }
+	// finishes the program if the driver says it's done linking, never blocks
+	// (always false without KHR_parallel_shader_compile, the batch handles that case)
+	bool Poll();
 
 	void Activate();
+	// frees the program early, the destructor does it otherwise
 	void Delete();
 
+	// resolve a uniform once at load time, complains if the program doesn't have it
+	UniformHandle Uniform(const char *name);
+	const std::vector<UniformInfo> &Uniforms() const { return uniforms; }
+	// the rest of what the program was reflected into when it linked, empty
+	// until it's READY. VAO::Validate and VAO::Link check layouts against these
+	const std::vector<AttributeInfo> &Attributes() const { return attributes; }
+	const std::vector<SamplerInfo> &Samplers() const { return samplers; }
+	const std::vector<UniformBlockInfo> &Blocks() const { return blocks; }
+	// NULL if the program doesn't read an attribute by that name
+	const AttributeInfo *Attribute(const char *name) const;
+
+	// these activate the program and skip the upload if the value hasn't changed
+	void Set(UniformHandle uniform, GLfloat x);
+	void Set(UniformHandle uniform, GLfloat x, GLfloat y);
+	void Set(UniformHandle uniform, GLfloat x, GLfloat y, GLfloat z);
+	void Set(UniformHandle uniform, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
+	// ints also cover bools and samplers (the texture unit)
+	void Set(UniformHandle uniform, GLint x);
+	// column major, like glUniformMatrix4fv without transpose
+	void SetMatrix4(UniformHandle uniform, const GLfloat *matrix);
+
+	template<typename... Values>
+	void Set(const char *name, Values... values) {
+		Set(Uniform(name), values...);
+	}
+	void SetMatrix4(const char *name, const GLfloat *matrix) {
+		SetMatrix4(Uniform(name), matrix);
+	}
+
 private:
-	void compileErrors(unsigned int shader, const char *type);
+	friend class ShaderBatch;
+	friend class ShaderReloader;
+	friend class ShaderVariants;
+
+	// only kept while the program is PENDING
+	ShaderBatch *batch;
+	// only set while a ShaderReloader watches it
+	ShaderReloader *reloader;
+	std::string vertexCode;
+	std::string fragmentCode;
+	GLuint vertexShader;
+	GLuint fragmentShader;
+	unsigned long long cacheKey;
+	// time spent in begin, compile, link and finish so far, not waiting in a batch between them
+	double loadMs;
+
+	std::vector<UniformInfo> uniforms;
+	// open addressed, power of two sized, slots hold uniform index + 1 so 0 is empty
+	std::vector<int> uniformTable;
+	// names already reported as missing, so a bad name only complains once
+	std::vector<Names::Id> missingUniforms;
+	std::vector<AttributeInfo> attributes;
+	std::vector<SamplerInfo> samplers;
+	std::vector<UniformBlockInfo> blocks;
+
+	// prints the info log and returns false if the shader didn't compile (or the program didn't link)
+	bool compileErrors(unsigned int shader, const char *type);
+	Shader();
+	// takes the program from the cache if it can, otherwise leaves it PENDING
+	void begin(std::string vertex, std::string fragment);
+	void compile();
+	void link();
+	// checks the results, frees the stages, fills the cache and reflects uniforms
+	void finish();
+	// fills uniforms, attributes, samplers and blocks from the linked program
+	void reflect();
+	void reflectUniforms();
+	void reflectAttributes();
+	// points every block registered in UniformBlocks at its binding, and complains
+	// if the GLSL block isn't the size of its C++ mirror
+	void reflectBlocks();
+	// the sampler table, from uniforms
+	void collectSamplers();
+	void buildUniformTable();
+	// sends a uniform's cached value to the program in use
+	void uploadValue(const UniformInfo &uniform);
+	// takes a freshly linked program from next (which gets the old one), keeping
+	// every handle pointing at the same name and sending the cached values again
+	void swapProgram(Shader &next);
+	UniformHandle findUniform(Names::Id name) const;
+	// checks the setter matches the uniform and whether the value is new, then caches it
+	bool needsUpload(UniformHandle uniform, GLenum setterType, const void *value, size_t bytes);
+	// takes everything from other and leaves it empty
+	void take(Shader &other);
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,12 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec4 color;
+in vec2 texcoord;
+
+uniform sampler2D tex0;
+
+void main() {
+	// same flip as default.frag, then tint by the sprite color
+	FragColor = texture(tex0, vec2(texcoord.s, 1.0-texcoord.t)) * color;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec4 aCol;
+layout (location = 2) in vec2 aTex;
+
+out vec4 color;
+out vec2 texcoord;
+
+// sprites are placed in pixels, this turns them into clip space
+uniform vec2 viewSize;
+
+void main() {
+	gl_Position = vec4(aPos / viewSize * 2.0 - 1.0, 0.0, 1.0);
+	color = aCol;
+	texcoord = aTex;
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec4 color;
+in vec3 texcoord;
+
+uniform sampler2DArray tex0;
+
+void main() {
+	// same flip as sprite.frag, the layer passes straight through
+	FragColor = texture(tex0, vec3(texcoord.s, 1.0-texcoord.t, texcoord.p)) * color;
+}
\ No newline at end of file
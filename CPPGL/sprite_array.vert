@@ -0,0 +1,18 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec4 aCol;
+layout (location = 2) in vec2 aTex;
+// which layer of the texture array the sprite shows
+layout (location = 3) in float aLayer;
+
+out vec4 color;
+out vec3 texcoord;
+
+// sprites are placed in pixels, this turns them into clip space
+uniform vec2 viewSize;
+
+void main() {
+	gl_Position = vec4(aPos / viewSize * 2.0 - 1.0, 0.0, 1.0);
+	color = aCol;
+	texcoord = vec3(aTex, aLayer);
+}
\ No newline at end of file
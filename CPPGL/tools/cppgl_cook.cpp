@@ -0,0 +1,129 @@
+// offline texture cooker: turns png/jpg/tga/... into .ctex files the renderer
+// can map and upload without decoding (see CookedTexture.h and Texture::FromCooked)
+//
+// usage: cppgl_cook [--premultiply] [--levels N] [--format rgba8|bc1|bc3|bc7]
+//                   [--quality fast|normal|best] [--filter box|kaiser] [--linear]
+//                   [--alpha-cutoff A] input.png output.ctex
+//        cppgl_cook [options] --out-dir DIR input.png...
+// with --out-dir every input becomes DIR/<name>.ctex. compressed cooks decode
+// their blocks again and print the PSNR against the source. mips are filtered
+// in linear light unless --linear says the image isn't srgb, and --alpha-cutoff
+// keeps the share of pixels passing an alpha test the same down the chain
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "CookedTexture.h"
+
+static const char *USAGE =
+	"usage: cppgl_cook [--premultiply] [--levels N] [--format rgba8|bc1|bc3|bc7]\n"
+	"                  [--quality fast|normal|best] [--filter box|kaiser] [--linear]\n"
+	"                  [--alpha-cutoff A] input output.ctex\n"
+	"       cppgl_cook [options] --out-dir DIR input...";
+
+static const char *FORMAT_NAMES[] = { "bc1", "bc3", "bc7" };
+static const char *QUALITY_NAMES[] = { "fast", "normal", "best" };
+
+// index into names, -1 if it isn't there
+static int lookup(const std::string &value, const char **names, int count) {
+	for (int i = 0; i < count; i++) {
+		if (value == names[i]) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+int main(int argc, char **argv) {
+	CookedTexture::Options options;
+	std::string outDir;
+	std::vector<std::string> files;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--premultiply") {
+			options.premultiply = true;
+		} else if (arg == "--levels" && hasValue) {
+			options.levels = atoi(argv[++i]);
+		} else if (arg == "--format" && hasValue) {
+			std::string format = argv[++i];
+			int found = lookup(format, FORMAT_NAMES, 3);
+			if (format != "rgba8" && found < 0) {
+				std::cout << USAGE << std::endl;
+				return 2;
+			}
+			options.compress = found >= 0;
+			if (found >= 0) {
+				options.compression = (BlockCompression::Format)found;
+			}
+		} else if (arg == "--quality" && hasValue) {
+			int found = lookup(argv[++i], QUALITY_NAMES, 3);
+			if (found < 0) {
+				std::cout << USAGE << std::endl;
+				return 2;
+			}
+			options.quality = (BlockCompression::Quality)found;
+		} else if (arg == "--filter" && hasValue) {
+			std::string filter = argv[++i];
+			if (filter != "box" && filter != "kaiser") {
+				std::cout << USAGE << std::endl;
+				return 2;
+			}
+			options.mips.filter = filter == "box" ? MipGenerator::BOX : MipGenerator::KAISER;
+		} else if (arg == "--linear") {
+			options.mips.srgb = false;
+		} else if (arg == "--alpha-cutoff" && hasValue) {
+			options.mips.alphaCutoff = (float)atof(argv[++i]);
+		} else if (arg == "--out-dir" && hasValue) {
+			outDir = argv[++i];
+		} else if (arg.size() > 1 && arg[0] == '-') {
+			std::cout << USAGE << std::endl;
+			return 2;
+		} else {
+			files.push_back(arg);
+		}
+	}
+
+	// input output pairs, worked out up front so a bad command line writes nothing
+	std::vector<std::pair<std::string, std::string>> jobs;
+	if (outDir.empty()) {
+		if (files.size() != 2) {
+			std::cout << USAGE << std::endl;
+			return 2;
+		}
+		jobs.push_back({ files[0], files[1] });
+	} else {
+		if (files.empty()) {
+			std::cout << USAGE << std::endl;
+			return 2;
+		}
+		std::error_code error;
+		std::filesystem::create_directories(outDir, error);
+		for (const std::string &file : files) {
+			std::filesystem::path output = std::filesystem::path(outDir) / std::filesystem::path(file).stem();
+			output += ".ctex";
+			jobs.push_back({ file, output.string() });
+		}
+	}
+
+	int failed = 0;
+	for (const auto &job : jobs) {
+		CookedTexture::Report report;
+		if (!CookedTexture::Cook(job.first.c_str(), job.second.c_str(), options, &report)) {
+			failed++;
+		} else if (options.compress) {
+			printf("%s -> %s, %s %s, %.1f KB, %.2f dB PSNR, encoded in %.1f ms\n", job.first.c_str(),
+				job.second.c_str(), FORMAT_NAMES[options.compression], QUALITY_NAMES[options.quality],
+				report.bytes / 1024.0, report.psnr, report.encodeMs);
+		} else {
+			printf("%s -> %s, %.1f KB\n", job.first.c_str(), job.second.c_str(), report.bytes / 1024.0);
+		}
+	}
+	if (failed > 0) {
+		printf("%d of %zu failed\n", failed, jobs.size());
+		return 1;
+	}
+	return 0;
+}
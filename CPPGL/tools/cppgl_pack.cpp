@@ -0,0 +1,101 @@
+// offline asset packer: puts shaders, cooked textures, meshes and anything else
+// into one .pak the renderer maps once (see AssetArchive.h)
+//
+// usage: cppgl_pack [--compress] [--align N] [--root DIR] output.pak input...
+//        cppgl_pack --list archive.pak
+// directories are packed with everything under them. each asset is named by its
+// path relative to --root (the working directory by default) with forward
+// slashes, so "shaders/default.vert" is found by that name on every platform.
+// --compress lz compresses each asset that gets smaller for it, --align puts
+// every asset on that boundary (16 by default, 4096 for page aligned assets)
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "AssetArchive.h"
+
+static const char *USAGE =
+	"usage: cppgl_pack [--compress] [--align N] [--root DIR] output.pak input...\n"
+	"       cppgl_pack --list archive.pak";
+
+static int list(const char *path) {
+	AssetArchive archive(path);
+	if (!archive.IsOpen()) {
+		return 1;
+	}
+	for (size_t i = 0; i < archive.Count(); i++) {
+		AssetArchive::View view = archive.At(i);
+		if (view.compression == AssetArchive::NONE) {
+			printf("%10zu  %s\n", view.size, archive.Name(i).c_str());
+		} else {
+			printf("%10zu  %s (%zu packed)\n", view.rawSize, archive.Name(i).c_str(), view.size);
+		}
+	}
+	printf("%zu assets\n", archive.Count());
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	AssetArchive::PackOptions options;
+	std::filesystem::path root = std::filesystem::current_path();
+	std::vector<std::string> files;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--list" && hasValue) {
+			return list(argv[i + 1]);
+		} else if (arg == "--compress") {
+			options.compress = true;
+		} else if (arg == "--align" && hasValue) {
+			options.alignment = (uint32_t)atoi(argv[++i]);
+		} else if (arg == "--root" && hasValue) {
+			root = argv[++i];
+		} else if (arg.size() > 1 && arg[0] == '-') {
+			std::cout << USAGE << std::endl;
+			return 2;
+		} else {
+			files.push_back(arg);
+		}
+	}
+	if (files.size() < 2) {
+		std::cout << USAGE << std::endl;
+		return 2;
+	}
+
+	std::vector<AssetArchive::Input> inputs;
+	std::error_code error;
+	root = std::filesystem::absolute(root, error);
+	auto add = [&](const std::filesystem::path &path) {
+		std::filesystem::path relative = std::filesystem::absolute(path, error).lexically_relative(root);
+		if (relative.empty() || *relative.begin() == "..") {
+			// outside the root, so just the path it was given
+			relative = path;
+		}
+		inputs.push_back({ relative.generic_string(), path.string() });
+	};
+	for (size_t i = 1; i < files.size(); i++) {
+		std::filesystem::path path = files[i];
+		if (std::filesystem::is_directory(path, error)) {
+			for (const auto &item : std::filesystem::recursive_directory_iterator(path, error)) {
+				if (item.is_regular_file(error)) {
+					add(item.path());
+				}
+			}
+		} else {
+			add(path);
+		}
+	}
+
+	AssetArchive::PackReport report;
+	if (!AssetArchive::Pack(files[0].c_str(), inputs, options, &report)) {
+		return 1;
+	}
+	printf("%s: %zu assets, %.1f KB", files[0].c_str(), inputs.size(), report.bytes / 1024.0);
+	if (options.compress) {
+		printf(" from %.1f KB, %u compressed", report.rawBytes / 1024.0, report.compressed);
+	}
+	printf("\n");
+	return 0;
+}
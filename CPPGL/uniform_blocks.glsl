@@ -0,0 +1,19 @@
+#pragma once
+// the GLSL side of UniformBlocks.h, keep the two in step. the C++ structs check
+// their offsets against std140 at compile time, the shader checks their sizes
+// when it links
+
+// the same for every draw in a frame, bound once
+layout(std140) uniform Frame {
+	mat4 viewProjection;
+	vec2 viewport;
+	float time;
+	float scale;
+} frame;
+
+// one draw's worth, bound from a ring buffer per draw
+layout(std140) uniform Object {
+	mat4 transform;
+	vec4 tint;
+	vec4 uvRect;
+} object;